@@ -0,0 +1,62 @@
+#pragma once
+#ifndef TEEBEE_AUTOMATION_H_INCLUDED
+#define TEEBEE_AUTOMATION_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include "TeeBeeFilter.h"
+#include "TeeBeeState.h"
+
+/**
+ * Sample-accurate automation and audio-rate modulation (FilterAlphaThree)
+ * - A TeeBeeParameterEvent is an automation point inside a block, as VST3 and CLAP hosts send
+ *   them: the parameter glides linearly from its previous value to `value` at `offset`; a mode
+ *   point switches (with the usual crossfade) at its offset
+ * - TeeBeeMultiChannelFilter::processAutomated() splits the block at every point, so the
+ *   result does not depend on where the host's blocks begin
+ * - TeeBeeModulationDepth maps a modulation signal (a sidechain, nominally -1..1) onto cutoff
+ *   (in octaves) and resonance (in percent); the engine applies it on a fixed grid of
+ *   modulation segments
+ * - Nothing here allocates: events are read from the caller's array
+ */
+
+struct TeeBeeParameterEvent
+{
+    int offset = 0;     // Samples from the start of the block, 0..numSamples
+    int parameter = 0;  // PARAM_CUTOFF, PARAM_RESONANCE, PARAM_DRIVE, PARAM_FB_HP, PARAM_FB_AMP or PARAM_MODE
+    double value = 0.0; // Plain value, in TeeBeeParameters units
+};
+
+struct TeeBeeModulationDepth
+{
+    double cutoffOctaves = 0.0; // Cutoff moves by this many octaves at full-scale modulation
+    double resonance = 0.0;     // Resonance moves by this many percent at full-scale modulation
+
+    bool isActive() const { return cutoffOctaves != 0.0 || resonance != 0.0; }
+};
+
+// The parameters a modulation value (clamped to -1..1) turns `base` into
+inline TeeBeeParameters teeBeeModulate(const TeeBeeParameters& base, const TeeBeeModulationDepth& depth, double amount)
+{
+    amount = std::clamp(amount, -1.0, 1.0);
+    TeeBeeParameters params = base;
+    if (depth.cutoffOctaves != 0.0) params.cutoff = std::clamp(base.cutoff * std::exp2(depth.cutoffOctaves * amount), 20.0, 20000.0);
+    if (depth.resonance != 0.0) params.resonance = std::clamp(base.resonance + depth.resonance * amount, 0.0, 100.0);
+    return params;
+}
+
+// Pointer to the TeeBeeParameters field an event targets, or nullptr (mode and the
+// non-automatable parameters)
+inline double* teeBeeContinuousParameter(TeeBeeParameters& params, int parameter)
+{
+    switch (parameter) {
+    case PARAM_CUTOFF: return &params.cutoff;
+    case PARAM_RESONANCE: return &params.resonance;
+    case PARAM_DRIVE: return &params.drive;
+    case PARAM_FB_HP: return &params.fbHp;
+    case PARAM_FB_AMP: return &params.fbAmp;
+    default: return nullptr;
+    }
+}
+
+#endif // TEEBEE_AUTOMATION_H_INCLUDED
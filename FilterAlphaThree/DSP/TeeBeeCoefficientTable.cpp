@@ -0,0 +1,21 @@
+#include "TeeBeeCoefficientTable.h"
+
+#include <map>
+#include <mutex>
+
+std::shared_ptr<const TeeBeeCoefficientTable> TeeBeeCoefficientTable::forSampleRate(double sampleRate)
+{
+    static std::mutex mutex;
+    static std::map<double, std::weak_ptr<const TeeBeeCoefficientTable>> tables;
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (auto table = tables[sampleRate].lock()) return table;
+
+    // Drop tables no instance uses any more, so memory follows the live sample rates
+    for (auto it = tables.begin(); it != tables.end();)
+        it = it->second.expired() ? tables.erase(it) : std::next(it);
+
+    auto table = std::make_shared<const TeeBeeCoefficientTable>(sampleRate);
+    tables[sampleRate] = table;
+    return table;
+}
@@ -0,0 +1,551 @@
+#pragma once
+#ifndef TEEBEE_FILTER_H_INCLUDED
+#define TEEBEE_FILTER_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "TeeBeeCoefficientTable.h"
+#include "TeeBeeKernel.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TEEBEE_HAS_SSE_CSR 1
+#endif
+
+/**
+ * TeeBeeFilter DSP core (FilterAlphaThree)
+ * - TB-303-style 4-pole diode ladder filter with high-pass feedback
+ * - Header-only and JUCE-free: shared by the plugin and the command-line tools
+ * - Double precision internally, float or double buffers, one instance per channel
+ * - The ladder's tanh saturator has three quality tiers (TeeBeeSaturators.h): pick one at
+ *   runtime with setQuality(), or at compile time with processBlockWith<Sat>()
+ * - rampTo() glides cutoff, resonance, drive and feedback to new values over the next
+ *   numSamples samples with per-sample coefficient updates and no exp() per sample
+ * - With a TeeBeeCoefficientTable for the current sample rate attached, setCutoff() and
+ *   setFeedbackHP() interpolate the pole terms instead of calling exp()
+ * - A mode change while the ladder is running crossfades from the old mode over
+ *   modeFadeSeconds; both modes run from the same state meanwhile, so the fade does not click
+ * - TB_303_ZDF solves the diode ladder without a delay in its feedback loop, so its resonant
+ *   peak sits at the cutoff at any sample rate and it needs no oversampling to stay in tune
+ */
+
+// Flushes denormals to zero for the lifetime of the object (FTZ/DAZ on x86, FZ on AArch64).
+class TeeBeeScopedNoDenormals
+{
+public:
+    TeeBeeScopedNoDenormals() noexcept
+    {
+#if defined(TEEBEE_HAS_SSE_CSR)
+        previous = _mm_getcsr();
+        _mm_setcsr(previous | 0x8040u);
+#elif defined(__aarch64__)
+        std::uint64_t fpcr;
+        asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+        previous = fpcr;
+        fpcr |= (1ull << 24);
+        asm volatile("msr fpcr, %0" : : "r"(fpcr));
+#endif
+    }
+
+    ~TeeBeeScopedNoDenormals() noexcept
+    {
+#if defined(TEEBEE_HAS_SSE_CSR)
+        _mm_setcsr(static_cast<unsigned int>(previous));
+#elif defined(__aarch64__)
+        std::uint64_t fpcr = previous;
+        asm volatile("msr fpcr, %0" : : "r"(fpcr));
+#endif
+    }
+
+    TeeBeeScopedNoDenormals(const TeeBeeScopedNoDenormals&) = delete;
+    TeeBeeScopedNoDenormals& operator=(const TeeBeeScopedNoDenormals&) = delete;
+
+private:
+    std::uint64_t previous = 0;
+};
+
+// TB-303 Filter (double precision internally)
+struct TeeBeeFilter
+{
+    enum Mode { TB_303, LP_24, LP_18, LP_12, HP_12, FLAT, TB_303_ZDF, NUM_MODES };
+
+    static constexpr double pi = 3.14159265358979323846;
+    static constexpr double modeFadeSeconds = 0.005;
+    static constexpr int modeFadeChunk = 64; // Samples per crossfade step (on the stack)
+
+    TeeBeeFilter();
+    void setSampleRate(double sr);
+    void reset();
+    void setCutoff(double fc, bool updateCoeffs = true);
+    void setResonance(double rPercent, bool updateCoeffs = true);
+    void setDriveDb(double db);
+    void setMode(int newMode);
+    void setFeedbackHP(double fc);
+    void setFeedbackAmp(double amp);
+    void setQuality(int newQuality);
+    // Shared pole-term table; used while its sample rate matches, must outlive the filter
+    void setCoefficientTable(const TeeBeeCoefficientTable* newTable);
+    // Moves to the given setter-unit values linearly over the next numSamples processed samples;
+    // the setters above (and another rampTo) end a pending ramp at its target first
+    void rampTo(double fc, double rPercent, double db, double fbHpFc, double amp, int numSamples);
+    int getRampSamplesRemaining() const { return rampRemaining; }
+    // Forgets a pending ramp without touching the coefficients (for callers that copied it elsewhere)
+    void discardRamp() { rampRemaining = 0; }
+    float processSample(float in);
+    void processBlock(float* data, int numSamples);
+    void processBlock(double* data, int numSamples);
+    // processBlock with the saturator fixed at compile time (ignores setQuality)
+    template <class Sat, class Sample> void processBlockWith(Sample* data, int numSamples);
+
+    double cutoff = 1000.0, resonanceRaw = 0.2, driveDb = 0.0, feedbackHpCutoff = 300.0, feedbackAmp = 0.5;
+    double sampleRate = 44100.0, twoPiOverSampleRate = 2.0 * pi / 44100.0;
+    int mode = TB_303;
+    int quality = QUALITY_EXACT;
+
+    static bool isValid(float v) { return std::isfinite(v); }
+
+    const TeeBeeModeTaps& getModeTaps() const { return teeBeeModeTaps[mode]; }
+    // Samples left of a mode crossfade
+    int getModeFadeRemaining() const { return fadeRemaining; }
+    const TeeBeeKernelSetup& getKernelSetup() const { return setup; }
+    // Copy into a lane block of any precision (rounded to its types)
+    template <class Block> void copyCoefficientsTo(Block& dest, int destLane) const;
+    template <class Block> void copyRampTo(Block& dest, int destLane) const;
+
+private:
+    double k = 0.0, driveFactor = 1.0, resonanceSkewed = 0.0;
+    int rampRemaining = 0;
+    TeeBeeKernelSetup setup; // Mode and saturator tier
+    TeeBeeLaneBlock<1> lane; // Coefficients and state
+    TeeBeeKernelSetup fadeSetup; // The mode being faded out, with its coefficients and state
+    TeeBeeLaneBlock<1> fadeLane;
+    int fadeRemaining = 0, fadeLength = static_cast<int>(modeFadeSeconds * 44100.0 + 0.5);
+    const TeeBeeCoefficientTable* table = nullptr;
+    void calculateCoefficientsApprox();
+    void updateCutoffCoeffs();
+    double poleTerm(double fc) const; // exp(-2*pi*fc/sampleRate)
+    double zdfGain(double fc) const;  // Prewarped so the zero-delay ladder peaks at fc
+    void updateFeedbackHPCoeffs();
+    void updateGains();
+    void finishRamp();
+    double resonanceGain() const
+    {
+        if (mode == TB_303_ZDF) {
+            // Self-oscillates from full resonance at 50% feedback amount
+            const double headroom = 1.0 - zdfAmount(resonanceSkewed);
+            return 2.0 * teeBeeZdfCriticalGain * (1.0 - headroom * headroom);
+        }
+        return mode == TB_303 ? resonanceSkewed * 4.0 * 1.5 : resonanceSkewed * 4.0;
+    }
+    double feedbackGain() const { return mode == TB_303_ZDF ? k * zdfAmount(feedbackAmp) : k * feedbackAmp; }
+    // Resonance and feedback amount arrive from the plug-in's parameters scaled by 0.01 twice (as
+    // the original processor passed them, and as the other modes keep hearing them); the zero-delay
+    // ladder undoes that so its controls span their whole range
+    static double zdfAmount(double value) { return std::min(value * 100.0, 1.0); }
+    template <class Sample> void processBlockAnyQuality(Sample* data, int numSamples);
+    template <class Sample> void guardNonFinite(Sample* data, int numSamples);
+    static double clip(double v, double lo, double hi) { return v < lo ? lo : (hi < v ? hi : v); }
+};
+
+static_assert(TeeBeeFilter::NUM_MODES == teeBeeNumModes, "teeBeeModeTaps must list every TeeBeeFilter::Mode");
+
+/**
+ * Host-facing parameter values, in the units of the plugin's parameter layout
+ * (Hz, %, dB, mode index, quality index). applyTo() performs the same mapping the plugin's
+ * processBlock does, so offline renders match what the plugin produces.
+ */
+struct TeeBeeParameters
+{
+    double cutoff = 1000.0, resonance = 20.0, drive = 0.0, fbHp = 300.0, fbAmp = 50.0;
+    int mode = TeeBeeFilter::TB_303;
+    int quality = QUALITY_EXACT;
+
+    bool operator==(const TeeBeeParameters&) const = default;
+
+    void applyTo(TeeBeeFilter& filter) const
+    {
+        filter.setCutoff(cutoff);
+        filter.setResonance(resonance * 0.01);
+        filter.setDriveDb(drive);
+        filter.setFeedbackHP(fbHp);
+        filter.setFeedbackAmp(fbAmp * 0.01);
+        filter.setMode(mode);
+        filter.setQuality(quality);
+    }
+
+    // Same mapping as applyTo(), but glides over numSamples; a mode change crossfades instead,
+    // quality switches at once
+    void rampTo(TeeBeeFilter& filter, int numSamples) const
+    {
+        filter.setQuality(quality);
+        if (mode != filter.mode) {
+            applyTo(filter);
+            return;
+        }
+        filter.rampTo(cutoff, resonance * 0.01, drive, fbHp, fbAmp * 0.01, numSamples);
+    }
+
+    // Seconds until the output stays below `threshold` after a full-scale input stops, measured
+    // by running a scratch filter (a few ms of CPU, so not on the audio thread); at most maxSeconds
+    double measureTailSeconds(double sampleRate, double threshold, double maxSeconds = 10.0) const;
+
+    // Small-signal magnitude response in dB at numPoints frequencies (Hz), from `seconds` of a
+    // scratch filter's impulse response (one Goertzel filter per frequency); a few ms of CPU,
+    // so not on the audio thread either
+    void measureMagnitudeResponse(double sampleRate, const double* frequencies, float* magnitudesDb, int numPoints,
+                                  double seconds = 0.1) const;
+};
+
+// Filter Implementation
+inline TeeBeeFilter::TeeBeeFilter()
+{
+    lane.b0[0] = 1.0;
+    lane.hpA0[0] = 1.0;
+    lane.hpA1[0] = -1.0;
+    calculateCoefficientsApprox();
+    updateFeedbackHPCoeffs();
+    reset();
+}
+
+inline void TeeBeeFilter::setSampleRate(double sr)
+{
+    finishRamp();
+    if (sr >= 44100.0) {
+        sampleRate = sr;
+        twoPiOverSampleRate = 2.0 * pi / sr;
+        fadeLength = std::max(1, static_cast<int>(modeFadeSeconds * sr + 0.5));
+        updateFeedbackHPCoeffs();
+        calculateCoefficientsApprox();
+        reset();
+    }
+}
+
+inline void TeeBeeFilter::reset()
+{
+    lane.resetLane(0);
+    fadeRemaining = 0;
+}
+
+inline void TeeBeeFilter::setCutoff(double fc, bool updateCoeffs)
+{
+    finishRamp();
+    cutoff = clip(fc, 20.0, 20000.0);
+    if (updateCoeffs) updateCutoffCoeffs();
+}
+
+inline void TeeBeeFilter::setResonance(double rPercent, bool updateCoeffs)
+{
+    finishRamp();
+    resonanceRaw = clip(rPercent, 0.0, 100.0) * 0.01;
+    resonanceSkewed = resonanceRaw;
+    if (updateCoeffs) {
+        k = resonanceGain();
+        updateGains();
+    }
+}
+
+inline void TeeBeeFilter::setDriveDb(double db)
+{
+    finishRamp();
+    driveDb = clip(db, -60.0, 60.0);
+    driveFactor = std::pow(10.0, driveDb * 0.05) * 0.25;
+    updateGains();
+}
+
+inline void TeeBeeFilter::setMode(int newMode)
+{
+    finishRamp();
+    if (newMode >= 0 && newMode < NUM_MODES) {
+        // A ladder at rest has nothing to click; otherwise keep running the old mode for the fade
+        if (newMode != mode && lane.laneStateMagnitude(0) > 0.0) {
+            fadeSetup = setup;
+            fadeLane = lane;
+            fadeRemaining = fadeLength;
+        }
+        // A finished ramp leaves only the running kernel's cutoff terms (b0/a1 or zdfG) at its
+        // target; the new mode may read the others
+        if (newMode != mode) updateCutoffCoeffs();
+        mode = newMode;
+        setup.mode = mode;
+        k = resonanceGain(); // Mode dependent too: resonance scaling and feedback gain
+        updateGains();
+    }
+}
+
+inline void TeeBeeFilter::setFeedbackHP(double fc)
+{
+    finishRamp();
+    feedbackHpCutoff = clip(fc, 20.0, 20000.0);
+    updateFeedbackHPCoeffs();
+}
+
+inline void TeeBeeFilter::setFeedbackAmp(double amp)
+{
+    finishRamp();
+    feedbackAmp = clip(amp, 0.0, 100.0) * 0.01;
+    updateGains();
+}
+
+inline void TeeBeeFilter::setCoefficientTable(const TeeBeeCoefficientTable* newTable)
+{
+    finishRamp();
+    table = newTable;
+    updateFeedbackHPCoeffs();
+    calculateCoefficientsApprox();
+}
+
+inline void TeeBeeFilter::setQuality(int newQuality)
+{
+    if (newQuality >= 0 && newQuality < NUM_QUALITIES) {
+        quality = newQuality;
+        setup.quality = newQuality;
+    }
+}
+
+/**
+ * Sets the parameters to their new values now, but leaves the coefficients to be stepped by
+ * the kernel over the next numSamples samples. Cutoff and feedback HP cutoff move linearly in
+ * Hz (a1 and hpB1 are exp(-w) terms, so each step is one multiply), drive linearly in dB
+ * (inputGain likewise), and the feedback gain linearly. At most four exp/pow per call, and
+ * none for parameters that do not change.
+ */
+inline void TeeBeeFilter::rampTo(double fc, double rPercent, double db, double fbHpFc, double amp, int numSamples)
+{
+    if (numSamples <= 0) {
+        setCutoff(fc, false);
+        setResonance(rPercent);
+        setDriveDb(db);
+        setFeedbackHP(fbHpFc);
+        setFeedbackAmp(amp);
+        return;
+    }
+    finishRamp();
+    const double n = static_cast<double>(numSamples);
+    const double fromCutoff = cutoff, fromFbHp = feedbackHpCutoff, fromDrive = driveDb, fromFbGain = feedbackGain();
+    cutoff = clip(fc, 20.0, 20000.0);
+    resonanceRaw = clip(rPercent, 0.0, 100.0) * 0.01;
+    resonanceSkewed = resonanceRaw;
+    k = resonanceGain();
+    driveDb = clip(db, -60.0, 60.0);
+    feedbackHpCutoff = clip(fbHpFc, 20.0, 20000.0);
+    feedbackAmp = clip(amp, 0.0, 100.0) * 0.01;
+
+    const double cutoffStep = (cutoff - fromCutoff) / n;
+    lane.b0Step[0] = cutoffStep / sampleRate;
+    lane.a1Ratio[0] = cutoffStep != 0.0 ? std::exp(-twoPiOverSampleRate * cutoffStep) : 1.0;
+    lane.zdfGStep[0] = (zdfGain(cutoff) - lane.zdfG[0]) / n;
+    const double fbHpStep = (feedbackHpCutoff - fromFbHp) / n;
+    lane.hpB1Ratio[0] = fbHpStep != 0.0 ? std::exp(-twoPiOverSampleRate * fbHpStep) : 1.0;
+    if (driveDb != fromDrive) {
+        driveFactor = std::pow(10.0, driveDb * 0.05) * 0.25;
+        lane.inputGainRatio[0] = std::pow(10.0, (driveDb - fromDrive) * 0.05 / n);
+    }
+    else
+        lane.inputGainRatio[0] = 1.0;
+    lane.fbGainStep[0] = (feedbackGain() - fromFbGain) / n;
+    rampRemaining = numSamples;
+}
+
+inline void TeeBeeFilter::finishRamp()
+{
+    if (rampRemaining > 0) {
+        rampRemaining = 0;
+        updateFeedbackHPCoeffs();
+        calculateCoefficientsApprox();
+    }
+}
+
+inline void TeeBeeFilter::updateFeedbackHPCoeffs()
+{
+    double x = poleTerm(feedbackHpCutoff);
+    lane.hpA0[0] = 1.0 + x;
+    lane.hpA1[0] = -(1.0 + x);
+    lane.hpB1[0] = -x;
+}
+
+inline double TeeBeeFilter::poleTerm(double fc) const
+{
+    if (table != nullptr && table->getSampleRate() == sampleRate) return table->expNegW(fc);
+    return std::exp(-2.0 * pi * fc / sampleRate);
+}
+
+inline double TeeBeeFilter::zdfGain(double fc) const
+{
+    // The linear ladder rings at teeBeeZdfPeakRatio times its stage corner; kept below Nyquist
+    return std::tan(pi * std::min(fc, 0.49 * sampleRate) / sampleRate) / teeBeeZdfPeakRatio;
+}
+
+inline void TeeBeeFilter::updateCutoffCoeffs()
+{
+    lane.a1[0] = -poleTerm(cutoff);
+    lane.b0[0] = cutoff / sampleRate;
+    lane.zdfG[0] = zdfGain(cutoff);
+}
+
+inline void TeeBeeFilter::calculateCoefficientsApprox()
+{
+    updateCutoffCoeffs();
+    k = resonanceGain();
+    updateGains();
+}
+
+inline void TeeBeeFilter::updateGains()
+{
+    lane.inputGain[0] = 0.125 * driveFactor;
+    lane.fbGain[0] = feedbackGain();
+}
+
+template <class Block>
+inline void TeeBeeFilter::copyCoefficientsTo(Block& dest, int destLane) const
+{
+    using Real = typename Block::Real;
+    using Wide = typename Block::Wide;
+    dest.inputGain[destLane] = static_cast<Real>(lane.inputGain[0]);
+    dest.fbGain[destLane] = static_cast<Wide>(lane.fbGain[0]);
+    dest.b0[destLane] = static_cast<Real>(lane.b0[0]);
+    dest.a1[destLane] = static_cast<Real>(lane.a1[0]);
+    dest.hpA0[destLane] = static_cast<Wide>(lane.hpA0[0]);
+    dest.hpA1[destLane] = static_cast<Wide>(lane.hpA1[0]);
+    dest.hpB1[destLane] = static_cast<Wide>(lane.hpB1[0]);
+    dest.zdfG[destLane] = static_cast<Real>(lane.zdfG[0]);
+}
+
+template <class Block>
+inline void TeeBeeFilter::copyRampTo(Block& dest, int destLane) const
+{
+    using Real = typename Block::Real;
+    using Wide = typename Block::Wide;
+    dest.inputGainRatio[destLane] = static_cast<Real>(lane.inputGainRatio[0]);
+    dest.fbGainStep[destLane] = static_cast<Wide>(lane.fbGainStep[0]);
+    dest.b0Step[destLane] = static_cast<Real>(lane.b0Step[0]);
+    dest.a1Ratio[destLane] = static_cast<Real>(lane.a1Ratio[0]);
+    dest.hpB1Ratio[destLane] = static_cast<Wide>(lane.hpB1Ratio[0]);
+    dest.zdfGStep[destLane] = static_cast<Real>(lane.zdfGStep[0]);
+}
+
+inline float TeeBeeFilter::processSample(float in)
+{
+    processBlock(&in, 1);
+    return in;
+}
+
+/**
+ * Processes numSamples in place. Mode/quality dispatch and the denormal guard happen once per
+ * block and the ladder state lives in locals for the whole loop. A pending ramp splits the
+ * block in two: the ramped part, then the rest with fixed coefficients. During a mode
+ * crossfade the old mode runs on a copy of the input, modeFadeChunk samples at a time, with
+ * the coefficients it had when the mode changed. The non-finite guard also runs once per
+ * block: if the state blew up, it is reset and the block is silenced.
+ */
+inline void TeeBeeFilter::processBlock(float* data, int numSamples)
+{
+    processBlockAnyQuality(data, numSamples);
+}
+
+inline void TeeBeeFilter::processBlock(double* data, int numSamples)
+{
+    processBlockAnyQuality(data, numSamples);
+}
+
+template <class Sample>
+inline void TeeBeeFilter::processBlockAnyQuality(Sample* data, int numSamples)
+{
+    switch (setup.quality) {
+    case QUALITY_TABLE: processBlockWith<TeeBeeTanhTable>(data, numSamples); break;
+    case QUALITY_PADE: processBlockWith<TeeBeeTanhPade>(data, numSamples); break;
+    default: processBlockWith<TeeBeeTanhExact>(data, numSamples); break;
+    }
+}
+
+template <class Sat, class Sample>
+inline void TeeBeeFilter::processBlockWith(Sample* data, int numSamples)
+{
+    if (numSamples <= 0) return;
+    TeeBeeScopedNoDenormals noDenormals;
+    for (int done = 0; done < numSamples;) {
+        setup.ramping = rampRemaining > 0;
+        int n = setup.ramping ? std::min(rampRemaining, numSamples - done) : numSamples - done;
+        Sample* channels[1] = { data + done };
+        if (fadeRemaining > 0) {
+            n = std::min({ n, fadeRemaining, modeFadeChunk });
+            Sample faded[modeFadeChunk];
+            std::copy(data + done, data + done + n, faded);
+            Sample* fadeChannels[1] = { faded };
+            teeBeeProcessLanesWith<TeeBeeScalarOps, Sat>(fadeSetup, fadeLane, 0, fadeChannels, n);
+            teeBeeProcessLanesWith<TeeBeeScalarOps, Sat>(setup, lane, 0, channels, n);
+            teeBeeCrossfade(faded, data + done, n, fadeRemaining, fadeLength);
+            fadeRemaining -= n;
+        }
+        else
+            teeBeeProcessLanesWith<TeeBeeScalarOps, Sat>(setup, lane, 0, channels, n);
+        if (setup.ramping) rampRemaining -= n;
+        done += n;
+    }
+    setup.ramping = false;
+    guardNonFinite(data, numSamples);
+}
+
+inline double TeeBeeParameters::measureTailSeconds(double sampleRate, double threshold, double maxSeconds) const
+{
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    applyTo(filter);
+    filter.reset();
+
+    // A 50 ms full-scale step charges the ladder and the DC blocker; the tail is what follows it
+    constexpr int chunk = 256;
+    float buffer[chunk];
+    for (int done = 0; done < static_cast<int>(0.05 * filter.sampleRate); done += chunk) {
+        std::fill(buffer, buffer + chunk, 1.0f);
+        filter.processBlock(buffer, chunk);
+    }
+    const int maxSamples = static_cast<int>(maxSeconds * filter.sampleRate);
+    const int quietRun = static_cast<int>(0.1 * filter.sampleRate); // Done after 100 ms below threshold
+    int lastLoud = 0;
+    for (int done = 0; done < maxSamples && done - lastLoud < quietRun; done += chunk) {
+        std::fill(buffer, buffer + chunk, 0.0f);
+        filter.processBlock(buffer, chunk);
+        for (int i = 0; i < chunk; ++i)
+            if (std::abs(buffer[i]) >= threshold) lastLoud = done + i + 1;
+    }
+    return std::min(maxSeconds, lastLoud / filter.sampleRate);
+}
+
+inline void TeeBeeParameters::measureMagnitudeResponse(double sampleRate, const double* frequencies, float* magnitudesDb,
+                                                       int numPoints, double seconds) const
+{
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    applyTo(filter);
+    filter.reset();
+
+    // Far below the saturators' knee even at full drive and resonance, so the ladder stays linear
+    constexpr double level = 1.0e-6;
+    std::vector<double> response(static_cast<size_t>(std::max(1, static_cast<int>(seconds * filter.sampleRate))), 0.0);
+    response[0] = level;
+    filter.processBlock(response.data(), static_cast<int>(response.size()));
+    for (int k = 0; k < numPoints; ++k) {
+        const double c = 2.0 * std::cos(filter.twoPiOverSampleRate * frequencies[k]);
+        double s1 = 0.0, s2 = 0.0;
+        for (double x : response) {
+            const double s0 = x + c * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        const double magnitude = std::sqrt(std::max(0.0, s1 * s1 + s2 * s2 - c * s1 * s2)) / level;
+        magnitudesDb[k] = static_cast<float>(20.0 * std::log10(std::max(magnitude, 1.0e-10)));
+    }
+}
+
+template <class Sample>
+inline void TeeBeeFilter::guardNonFinite(Sample* data, int numSamples)
+{
+    if (!lane.laneIsFinite(0) || (fadeRemaining > 0 && !fadeLane.laneIsFinite(0))) {
+        reset();
+        std::fill(data, data + numSamples, Sample(0));
+    }
+}
+
+#endif // TEEBEE_FILTER_H_INCLUDED
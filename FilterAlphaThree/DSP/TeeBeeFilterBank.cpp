@@ -0,0 +1,249 @@
+#include "TeeBeeFilterBank.h"
+
+#include <algorithm>
+
+TeeBeeFilterBank::TeeBeeFilterBank()
+    : isa(TeeBeeMultiChannelFilter::detectIsa())
+{
+}
+
+TeeBeeFilterBank::Isa TeeBeeFilterBank::setMaxIsa(Isa maxIsa)
+{
+    isa = std::min(maxIsa, TeeBeeMultiChannelFilter::detectIsa());
+    return isa;
+}
+
+// Setup
+void TeeBeeFilterBank::prepare(int maxVoices, double sampleRate, int maxBlockSize)
+{
+    maxVoices = std::max(0, maxVoices);
+    // Packed groups need at most N / 8 + 1 blocks each; one more for a voice moving between groups
+    const int numGroups = static_cast<int>(TeeBeeFilter::NUM_MODES) * static_cast<int>(NUM_QUALITIES);
+    const int numBlocks = (maxVoices + lanesPerBlock - 1) / lanesPerBlock + std::min(maxVoices, numGroups) + 1;
+    blocks.assign(static_cast<size_t>(numBlocks), LaneBlock{});
+    blockInfo.assign(static_cast<size_t>(numBlocks), BlockInfo{});
+    voices.assign(static_cast<size_t>(maxVoices), Voice{});
+    freeVoices.clear();
+    freeVoices.reserve(static_cast<size_t>(maxVoices));
+    for (VoiceId v = maxVoices - 1; v >= 0; --v) freeVoices.push_back(v);
+    scratch.assign(static_cast<size_t>(std::max(1, maxBlockSize)), 0.0f);
+    numFading = 0;
+
+    model.setSampleRate(sampleRate);
+    fadeLength = std::max(1, static_cast<int>(TeeBeeFilter::modeFadeSeconds * model.sampleRate + 0.5));
+    fadeOutput.assign(static_cast<size_t>(maxVoices) * static_cast<size_t>(fadeLength), 0.0f);
+    coefficientTable = TeeBeeCoefficientTable::forSampleRate(model.sampleRate);
+    model.setCoefficientTable(coefficientTable.get());
+}
+
+// Voices
+TeeBeeFilterBank::VoiceId TeeBeeFilterBank::allocateVoice(const TeeBeeParameters& params)
+{
+    if (freeVoices.empty()) return invalidVoice;
+    const VoiceId id = freeVoices.back();
+    freeVoices.pop_back();
+
+    Voice& voice = voices[static_cast<size_t>(id)];
+    voice.params = params;
+    params.applyTo(model);
+    attach(id);
+    blocks[static_cast<size_t>(voice.block)].resetLane(voice.lane);
+    model.copyCoefficientsTo(blocks[static_cast<size_t>(voice.block)], voice.lane);
+    return id;
+}
+
+void TeeBeeFilterBank::releaseVoice(VoiceId id)
+{
+    if (id < 0 || id >= getMaxVoices() || !isActive(id)) return;
+    Voice& voice = voices[static_cast<size_t>(id)];
+    stopModeFade(voice);
+    vacate(voice.block, voice.lane);
+    voice.block = -1;
+    freeVoices.push_back(id);
+}
+
+void TeeBeeFilterBank::releaseAllVoices()
+{
+    for (VoiceId id = 0; id < getMaxVoices(); ++id) releaseVoice(id);
+}
+
+void TeeBeeFilterBank::setVoiceParameters(VoiceId id, const TeeBeeParameters& params)
+{
+    if (id < 0 || id >= getMaxVoices() || !isActive(id)) return;
+    Voice& voice = voices[static_cast<size_t>(id)];
+    if (params.mode != voice.params.mode) startModeFade(voice, params);
+    params.applyTo(model);
+
+    if (params.mode != voice.params.mode || params.quality != voice.params.quality) {
+        // Claim a slot in the new group first, then carry the state over and free the old slot
+        const int oldBlock = voice.block, oldLane = voice.lane;
+        voice.params = params;
+        attach(id);
+        blocks[static_cast<size_t>(oldBlock)].copyLaneTo(oldLane, blocks[static_cast<size_t>(voice.block)], voice.lane);
+        vacate(oldBlock, oldLane);
+    }
+    voice.params = params;
+    model.copyCoefficientsTo(blocks[static_cast<size_t>(voice.block)], voice.lane);
+}
+
+void TeeBeeFilterBank::resetVoice(VoiceId id)
+{
+    if (id < 0 || id >= getMaxVoices() || !isActive(id)) return;
+    Voice& voice = voices[static_cast<size_t>(id)];
+    stopModeFade(voice);
+    blocks[static_cast<size_t>(voice.block)].resetLane(voice.lane);
+}
+
+// Mode Crossfades
+void TeeBeeFilterBank::startModeFade(Voice& voice, const TeeBeeParameters& params)
+{
+    // The voice is still in its old block. A ladder at rest has nothing to click
+    const auto& block = blocks[static_cast<size_t>(voice.block)];
+    if (block.laneStateMagnitude(voice.lane) <= 0.0) return;
+    if (voice.fadeRemaining == 0) ++numFading;
+    block.copyLaneTo(voice.lane, voice.fadeLane, 0);
+    // TeeBeeParameters::applyTo() sets the mode last, so TeeBeeFilter fades out the old mode
+    // with the new cutoff, resonance and feedback already in place: the same here
+    TeeBeeParameters oldMode = params;
+    oldMode.mode = voice.params.mode;
+    oldMode.applyTo(model);
+    model.copyCoefficientsTo(voice.fadeLane, 0);
+    voice.fadeSetup = model.getKernelSetup();
+    voice.fadeSetup.ramping = false;
+    voice.fadeRemaining = fadeLength;
+}
+
+void TeeBeeFilterBank::stopModeFade(Voice& voice)
+{
+    if (voice.fadeRemaining == 0) return;
+    voice.fadeRemaining = 0;
+    --numFading;
+}
+
+void TeeBeeFilterBank::processModeFades(float* const* voiceBuffers, int numSamples)
+{
+    for (size_t v = 0; v < voices.size(); ++v) {
+        Voice& voice = voices[v];
+        if (voice.fadeRemaining == 0) continue;
+        // Both modes share the voice's saturator, as in TeeBeeFilter
+        voice.fadeSetup.quality = voice.params.quality;
+        const int n = std::min(numSamples, voice.fadeRemaining);
+        float* faded = fadeOutput.data() + v * static_cast<size_t>(fadeLength);
+        std::copy(voiceBuffers[v], voiceBuffers[v] + n, faded);
+        float* fadeChannels[1] = { faded };
+        teeBeeProcessLanes<TeeBeeScalarOps>(voice.fadeSetup, voice.fadeLane, 0, fadeChannels, n);
+    }
+}
+
+void TeeBeeFilterBank::finishModeFades(float* const* voiceBuffers, int numSamples)
+{
+    for (size_t v = 0; v < voices.size(); ++v) {
+        Voice& voice = voices[v];
+        if (voice.fadeRemaining == 0) continue;
+        const int n = std::min(numSamples, voice.fadeRemaining);
+        // A blown-up old mode is dropped rather than mixed in
+        if (voice.fadeLane.laneIsFinite(0))
+            teeBeeCrossfade(fadeOutput.data() + v * static_cast<size_t>(fadeLength), voiceBuffers[v], n,
+                            voice.fadeRemaining, fadeLength);
+        voice.fadeRemaining -= n;
+        if (voice.fadeRemaining == 0) --numFading;
+        else if (!voice.fadeLane.laneIsFinite(0)) stopModeFade(voice);
+    }
+}
+
+// Block Management
+int TeeBeeFilterBank::findPartlyFilledBlock(int mode, int quality) const
+{
+    for (size_t b = 0; b < blockInfo.size(); ++b) {
+        const auto& info = blockInfo[b];
+        if (info.numVoices > 0 && info.numVoices < lanesPerBlock && info.mode == mode && info.quality == quality)
+            return static_cast<int>(b);
+    }
+    return -1;
+}
+
+int TeeBeeFilterBank::findEmptyBlock() const
+{
+    for (size_t b = 0; b < blockInfo.size(); ++b)
+        if (blockInfo[b].numVoices == 0) return static_cast<int>(b);
+    return -1;
+}
+
+void TeeBeeFilterBank::attach(VoiceId id)
+{
+    Voice& voice = voices[static_cast<size_t>(id)];
+    int b = findPartlyFilledBlock(voice.params.mode, voice.params.quality);
+    if (b < 0) {
+        b = findEmptyBlock(); // Always found: prepare() sized the blocks for the worst case
+        auto& info = blockInfo[static_cast<size_t>(b)];
+        info.mode = voice.params.mode;
+        info.quality = voice.params.quality;
+        info.setup = model.getKernelSetup(); // The model holds this voice's parameters
+        info.setup.ramping = false;
+    }
+    auto& info = blockInfo[static_cast<size_t>(b)];
+    voice.block = b;
+    voice.lane = info.numVoices++;
+    info.voices[voice.lane] = id;
+}
+
+void TeeBeeFilterBank::vacate(int b, int lane)
+{
+    auto& info = blockInfo[static_cast<size_t>(b)];
+    const int last = info.numVoices - 1;
+    if (lane != last) moveVoice(info.voices[last], b, lane);
+    --info.numVoices;
+
+    // Keep one partly filled block per group: top this one up from the other, if there is one
+    if (info.numVoices == 0) return;
+    for (size_t p = 0; p < blockInfo.size(); ++p) {
+        auto& other = blockInfo[p];
+        if (static_cast<int>(p) == b || other.numVoices == 0 || other.numVoices == lanesPerBlock
+            || other.mode != info.mode || other.quality != info.quality)
+            continue;
+        moveVoice(other.voices[other.numVoices - 1], b, info.numVoices);
+        ++info.numVoices;
+        --other.numVoices;
+        return;
+    }
+}
+
+void TeeBeeFilterBank::moveVoice(VoiceId id, int b, int lane)
+{
+    Voice& voice = voices[static_cast<size_t>(id)];
+    blocks[static_cast<size_t>(voice.block)].copyLaneTo(voice.lane, blocks[static_cast<size_t>(b)], lane);
+    blockInfo[static_cast<size_t>(b)].voices[lane] = id;
+    voice.block = b;
+    voice.lane = lane;
+}
+
+// Processing
+void TeeBeeFilterBank::process(float* const* voiceBuffers, int numSamples)
+{
+    if (numSamples <= 0) return;
+    TeeBeeScopedNoDenormals noDenormals;
+    if (numFading > 0) processModeFades(voiceBuffers, numSamples);
+
+    const int maxChunk = static_cast<int>(scratch.size());
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const auto& info = blockInfo[b];
+        if (info.numVoices == 0) continue;
+        for (int offset = 0, n = 0; offset < numSamples; offset += n) {
+            n = std::min(maxChunk, numSamples - offset);
+            float* laneData[lanesPerBlock];
+            for (int lane = 0; lane < lanesPerBlock; ++lane)
+                laneData[lane] = lane < info.numVoices ? voiceBuffers[info.voices[lane]] + offset : scratch.data();
+            if (info.numVoices < lanesPerBlock) std::fill(scratch.begin(), scratch.begin() + n, 0.0f);
+
+            TeeBeeMultiChannelFilter::processLaneBlock(isa, blocks[b], info.numVoices, info.setup, laneData, n);
+
+            for (int lane = 0; lane < info.numVoices; ++lane) {
+                if (!blocks[b].laneIsFinite(lane)) {
+                    blocks[b].resetLane(lane);
+                    std::fill(laneData[lane], laneData[lane] + n, 0.0f);
+                }
+            }
+        }
+    }
+    if (numFading > 0) finishModeFades(voiceBuffers, numSamples);
+}
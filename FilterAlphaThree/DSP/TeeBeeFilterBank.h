@@ -0,0 +1,105 @@
+#pragma once
+#ifndef TEEBEE_FILTER_BANK_H_INCLUDED
+#define TEEBEE_FILTER_BANK_H_INCLUDED
+
+#include <memory>
+#include <vector>
+#include "TeeBeeMultiChannelFilter.h"
+
+/**
+ * TeeBeeFilterBank (FilterAlphaThree)
+ * - Up to maxVoices independent ladders (synth voices, stems), each with its own parameters,
+ *   buffer and state
+ * - Voices live in 8-lane TeeBeeLaneBlocks (structure-of-arrays, 168 bytes per voice) and are
+ *   processed a block at a time by the SIMD kernels of TeeBeeMultiChannelFilter
+ * - A block runs one kernel setup, so voices are grouped by mode and quality; blocks stay packed
+ *   (lanes 0..n-1) and each mode/quality group has at most one partly filled block, so N voices
+ *   never take more than N / 8 + 1 blocks per group in use
+ * - prepare() allocates everything; allocateVoice(), releaseVoice(), setVoiceParameters() and
+ *   process() never allocate
+ * - A mode change while a voice is running crossfades from the old mode over
+ *   TeeBeeFilter::modeFadeSeconds, like TeeBeeFilter::setMode(): the old mode runs on a scalar
+ *   copy of the voice's lane meanwhile
+ * - Each voice's output is bit-identical to a TeeBeeFilter with the same parameters, mode
+ *   crossfades included
+ */
+class TeeBeeFilterBank
+{
+public:
+    using VoiceId = int;
+    static constexpr VoiceId invalidVoice = -1;
+    static constexpr int lanesPerBlock = TeeBeeMultiChannelFilter::lanesPerBlock;
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    using LaneBlock = TeeBeeMultiChannelFilter::LaneBlock;
+
+    TeeBeeFilterBank();
+
+    // Releases every voice
+    void prepare(int maxVoices, double sampleRate, int maxBlockSize);
+
+    // Returns invalidVoice when all maxVoices are in use. The voice starts from rest
+    VoiceId allocateVoice(const TeeBeeParameters& params);
+    void releaseVoice(VoiceId voice);
+    void releaseAllVoices();
+    // A mode or quality change moves the voice to another block, keeping its state; a mode
+    // change crossfades
+    void setVoiceParameters(VoiceId voice, const TeeBeeParameters& params);
+    const TeeBeeParameters& getVoiceParameters(VoiceId voice) const { return voices[static_cast<size_t>(voice)].params; }
+    void resetVoice(VoiceId voice);
+
+    // voiceBuffers[id] is voice id's in/out buffer; entries of released voices are not touched
+    void process(float* const* voiceBuffers, int numSamples);
+
+    int getMaxVoices() const { return static_cast<int>(voices.size()); }
+    int getNumActiveVoices() const { return getMaxVoices() - static_cast<int>(freeVoices.size()); }
+    bool isActive(VoiceId voice) const { return voices[static_cast<size_t>(voice)].block >= 0; }
+
+    // Caps the kernels used to `maxIsa`; returns the effective ISA
+    Isa setMaxIsa(Isa maxIsa);
+    Isa getIsa() const { return isa; }
+
+private:
+    struct Voice
+    {
+        TeeBeeParameters params;
+        int block = -1, lane = 0; // block < 0: free
+        TeeBeeKernelSetup fadeSetup; // The mode being faded out, with its coefficients and state
+        TeeBeeLaneBlock<1> fadeLane;
+        int fadeRemaining = 0;
+    };
+
+    struct BlockInfo
+    {
+        TeeBeeKernelSetup setup;
+        int mode = 0, quality = 0, numVoices = 0;
+        VoiceId voices[lanesPerBlock] = {};
+    };
+
+    // Puts a voice into the partly filled block of its mode/quality group (or an empty block)
+    void attach(VoiceId voice);
+    // Empties a slot, refilling the hole so blocks stay packed
+    void vacate(int block, int lane);
+    void moveVoice(VoiceId voice, int block, int lane);
+    int findPartlyFilledBlock(int mode, int quality) const;
+    int findEmptyBlock() const;
+    // Before `params` reach the model
+    void startModeFade(Voice& voice, const TeeBeeParameters& params);
+    void stopModeFade(Voice& voice);
+    // Runs the old mode of each fading voice on a copy of its input (before the blocks overwrite it)
+    void processModeFades(float* const* voiceBuffers, int numSamples);
+    // Mixes that into the voices' new-mode output
+    void finishModeFades(float* const* voiceBuffers, int numSamples);
+
+    TeeBeeFilter model; // Computes coefficients from parameters
+    std::shared_ptr<const TeeBeeCoefficientTable> coefficientTable;
+    std::vector<LaneBlock> blocks;
+    std::vector<BlockInfo> blockInfo;
+    std::vector<Voice> voices;
+    std::vector<VoiceId> freeVoices; // Stack of unused ids
+    std::vector<float> scratch;      // Input/output of unused lanes
+    std::vector<float> fadeOutput;   // Old mode's output, fadeLength samples per voice
+    int fadeLength = 1, numFading = 0;
+    Isa isa = Isa::Scalar;
+};
+
+#endif // TEEBEE_FILTER_BANK_H_INCLUDED
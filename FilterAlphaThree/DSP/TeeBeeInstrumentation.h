@@ -0,0 +1,266 @@
+#pragma once
+#ifndef TEEBEE_INSTRUMENTATION_H_INCLUDED
+#define TEEBEE_INSTRUMENTATION_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Per-block CPU instrumentation (FilterAlphaThree)
+ * - The audio thread times each block with TeeBeeBlockTimer and pushes one TeeBeeBlockTiming
+ *   into a lock-free single-producer/single-consumer ring; it never blocks or allocates
+ * - One reader (the editor's timer, the render tool) drains the ring into a TeeBeeTimingWindow,
+ *   which reports min/avg/p99 cycles per sample frame, the share spent in parameter smoothing
+ *   and the clip-guard and non-finite-reset counts
+ * - Cycles come from the time-stamp counter on x86 (virtual counter ticks on AArch64,
+ *   steady_clock nanoseconds elsewhere)
+ * - Configure with -DFILTERALPHA_INSTRUMENTATION=OFF to compile it out: TEEBEE_INSTRUMENTATION
+ *   is then 0, the timer and sections are empty and the engine keeps no counters
+ */
+
+#ifndef TEEBEE_INSTRUMENTATION
+#define TEEBEE_INSTRUMENTATION 1
+#endif
+
+inline std::uint64_t teeBeeReadCycleCounter() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// One processed block
+struct TeeBeeBlockTiming
+{
+    std::uint64_t cycles = 0;          // The whole block
+    std::uint64_t smoothingCycles = 0; // Part of `cycles` spent advancing smoothers and setting up ramps
+    std::uint32_t numSamples = 0;      // Sample frames
+    std::uint32_t numChannels = 0;
+    std::uint32_t clipGuards = 0;      // Samples clipped by the ladder's ±2 input guard (all channels)
+    std::uint32_t nonFiniteResets = 0; // Lanes reset because their state blew up
+
+    double cyclesPerSample() const { return numSamples > 0 ? static_cast<double>(cycles) / numSamples : 0.0; }
+};
+
+// Lock-free ring for one writer thread and one reader thread; a push onto a full ring is dropped
+template <class T, std::size_t Capacity>
+class TeeBeeSpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    bool push(const T& item) noexcept
+    {
+        const std::uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) noexcept
+    {
+        const std::uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = items[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pushes dropped since the last call (reader side)
+    std::uint32_t takeDropped() noexcept { return dropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::array<T, Capacity> items {};
+    alignas(64) std::atomic<std::uint32_t> head { 0 };
+    alignas(64) std::atomic<std::uint32_t> tail { 0 };
+    std::atomic<std::uint32_t> dropped { 0 };
+};
+
+using TeeBeeTimingRing = TeeBeeSpscRing<TeeBeeBlockTiming, TEEBEE_INSTRUMENTATION ? 1024 : 1>;
+
+struct TeeBeeTimingStats
+{
+    std::uint64_t blocks = 0;  // In the window
+    std::uint64_t dropped = 0; // Blocks lost to a full ring, since clear()
+    double minCyclesPerSample = 0.0, avgCyclesPerSample = 0.0, p99CyclesPerSample = 0.0;
+    double smoothingShare = 0.0;   // Fraction of the window's cycles spent in smoothing
+    double cyclesPerSecond = 0.0;  // Counter rate, 0 until measured
+    std::uint64_t clipGuards = 0, nonFiniteResets = 0; // Since clear()
+
+    // Share of the real-time budget used at p99, 0 while the counter rate is unknown
+    double p99Load(double sampleRate) const
+    {
+        return cyclesPerSecond > 0.0 ? p99CyclesPerSample * sampleRate / cyclesPerSecond : 0.0;
+    }
+};
+
+/**
+ * Reader side: keeps the last windowSize blocks for the statistics. Allocates only in the
+ * constructor. The counter rate is measured against steady_clock between construction (or
+ * clear()) and getStats(), once at least 10 ms have passed.
+ */
+class TeeBeeTimingWindow
+{
+public:
+    explicit TeeBeeTimingWindow(std::size_t windowSize = 4096)
+        : blocks(std::max<std::size_t>(1, windowSize)), sorted(blocks.size())
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        count = next = 0;
+        dropped = clipGuards = nonFiniteResets = 0;
+        startCycles = teeBeeReadCycleCounter();
+        startTime = std::chrono::steady_clock::now();
+    }
+
+    void add(const TeeBeeBlockTiming& timing)
+    {
+        blocks[next] = timing;
+        next = (next + 1) % blocks.size();
+        count = std::min(count + 1, blocks.size());
+        clipGuards += timing.clipGuards;
+        nonFiniteResets += timing.nonFiniteResets;
+    }
+
+    // Moves everything queued in the ring into the window; returns the number of blocks
+    template <class Ring> std::size_t drain(Ring& ring)
+    {
+        std::size_t n = 0;
+        for (TeeBeeBlockTiming timing; ring.pop(timing); ++n) add(timing);
+        dropped += ring.takeDropped();
+        return n;
+    }
+
+    TeeBeeTimingStats getStats()
+    {
+        TeeBeeTimingStats stats;
+        stats.blocks = count;
+        stats.dropped = dropped;
+        stats.clipGuards = clipGuards;
+        stats.nonFiniteResets = nonFiniteResets;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (seconds >= 0.01) stats.cyclesPerSecond = static_cast<double>(teeBeeReadCycleCounter() - startCycles) / seconds;
+        if (count == 0) return stats;
+
+        std::uint64_t cycles = 0, smoothing = 0, samples = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            cycles += blocks[i].cycles;
+            smoothing += blocks[i].smoothingCycles;
+            samples += blocks[i].numSamples;
+            sorted[i] = blocks[i].cyclesPerSample();
+        }
+        const auto p99 = sorted.begin() + static_cast<std::ptrdiff_t>((count - 1) * 99 / 100);
+        std::nth_element(sorted.begin(), p99, sorted.begin() + static_cast<std::ptrdiff_t>(count));
+        stats.p99CyclesPerSample = *p99;
+        stats.minCyclesPerSample = *std::min_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(count));
+        stats.avgCyclesPerSample = samples > 0 ? static_cast<double>(cycles) / static_cast<double>(samples) : 0.0;
+        stats.smoothingShare = cycles > 0 ? static_cast<double>(smoothing) / static_cast<double>(cycles) : 0.0;
+        return stats;
+    }
+
+private:
+    std::vector<TeeBeeBlockTiming> blocks; // Circular, `count` valid entries
+    std::vector<double> sorted;            // Scratch for the percentile
+    std::size_t count = 0, next = 0;
+    std::uint64_t dropped = 0, clipGuards = 0, nonFiniteResets = 0;
+    std::uint64_t startCycles = 0;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#if TEEBEE_INSTRUMENTATION
+
+// Adds the cycles of its scope to `total`
+class TeeBeeCycleSection
+{
+public:
+    explicit TeeBeeCycleSection(std::uint64_t& total) noexcept : total(total), start(teeBeeReadCycleCounter()) {}
+    ~TeeBeeCycleSection() { total += teeBeeReadCycleCounter() - start; }
+    TeeBeeCycleSection(const TeeBeeCycleSection&) = delete;
+    TeeBeeCycleSection& operator=(const TeeBeeCycleSection&) = delete;
+
+private:
+    std::uint64_t& total;
+    std::uint64_t start;
+};
+
+// Times one block on the audio thread and pushes its record when it goes out of scope
+class TeeBeeBlockTimer
+{
+public:
+    TeeBeeBlockTimer(TeeBeeTimingRing& ring, int numSamples, int numChannels) noexcept
+        : ring(ring), start(teeBeeReadCycleCounter())
+    {
+        record.numSamples = static_cast<std::uint32_t>(numSamples);
+        record.numChannels = static_cast<std::uint32_t>(numChannels);
+    }
+    ~TeeBeeBlockTimer()
+    {
+        record.cycles = teeBeeReadCycleCounter() - start;
+        ring.push(record);
+    }
+    TeeBeeBlockTimer(const TeeBeeBlockTimer&) = delete;
+    TeeBeeBlockTimer& operator=(const TeeBeeBlockTimer&) = delete;
+
+    std::uint64_t& smoothingCycles() noexcept { return record.smoothingCycles; }
+    // Counts from the engine (TeeBeeMultiChannelFilter::takeCounters)
+    void addCounts(std::uint32_t clipGuards, std::uint32_t nonFiniteResets) noexcept
+    {
+        record.clipGuards += clipGuards;
+        record.nonFiniteResets += nonFiniteResets;
+    }
+
+private:
+    TeeBeeTimingRing& ring;
+    std::uint64_t start;
+    TeeBeeBlockTiming record;
+};
+
+#else
+
+class TeeBeeCycleSection
+{
+public:
+    explicit TeeBeeCycleSection(std::uint64_t&) noexcept {}
+};
+
+class TeeBeeBlockTimer
+{
+public:
+    TeeBeeBlockTimer(TeeBeeTimingRing&, int, int) noexcept {}
+    std::uint64_t& smoothingCycles() noexcept { return unused; }
+    void addCounts(std::uint32_t, std::uint32_t) noexcept {}
+
+private:
+    std::uint64_t unused = 0;
+};
+
+#endif // TEEBEE_INSTRUMENTATION
+
+#endif // TEEBEE_INSTRUMENTATION_H_INCLUDED
@@ -0,0 +1,493 @@
+#pragma once
+#ifndef TEEBEE_KERNEL_H_INCLUDED
+#define TEEBEE_KERNEL_H_INCLUDED
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include "TeeBeeSaturators.h"
+
+/**
+ * TeeBee ladder kernel (FilterAlphaThree)
+ * - One implementation of the per-sample ladder math, generic over a lane type:
+ *   TeeBeeScalarOps (one double) for TeeBeeFilter, SIMD ops from TeeBeeSimdOps.h
+ *   for TeeBeeMultiChannelFilter (one channel per lane)
+ * - Coefficients and state are stored structure-of-arrays in TeeBeeLaneBlock
+ * - The tanh saturator and the filter mode are template parameters: each mode gets its own
+ *   kernel, picked from a dispatch table once per block, which computes only the output taps
+ *   that mode uses
+ * - Three precisions: double throughout; float throughout; mixed, where the ladder runs in
+ *   float and the feedback path (last stage, feedback low-pass and high-pass) stays in double.
+ *   A lane type's WideOps is the type the feedback path runs in (itself, except for mixed)
+ * - Audio I/O is float or double, independent of the precision
+ * - TB_303_ZDF runs its own kernel (teeBeeProcessZdfLanes): a zero-delay-feedback diode ladder
+ *   whose implicit equations are solved by a capped Newton iteration every sample
+ */
+
+enum TeeBeePrecision { PRECISION_DOUBLE, PRECISION_MIXED, PRECISION_FLOAT, NUM_PRECISIONS };
+
+enum TeeBeeLadder
+{
+    LADDER_LINEAR,     // Four one-poles, the mode's taps mixed as the output
+    LADDER_TB303,      // tanh between the stages, y4 as the output without the tap gain
+    LADDER_ZERO_DELAY  // Diode ladder without a delay in the feedback loop (teeBeeProcessZdfLanes)
+};
+
+// Ladder topology and output tap weights (y0..y4) of a filter mode
+struct TeeBeeModeTaps
+{
+    TeeBeeLadder ladder;
+    double c[5];
+
+    constexpr int firstTap() const
+    {
+        int tap = 0;
+        while (tap < 4 && c[tap] == 0.0) ++tap;
+        return tap;
+    }
+};
+
+// Indexed by TeeBeeFilter::Mode. LP_24 has TB_303's taps but the linear ladder
+inline constexpr TeeBeeModeTaps teeBeeModeTaps[] = {
+    { LADDER_TB303, { 0.0, 0.0, 0.0, 0.0, 1.0 } },      // TB_303
+    { LADDER_LINEAR, { 0.0, 0.0, 0.0, 0.0, 1.0 } },     // LP_24
+    { LADDER_LINEAR, { 0.0, 0.0, 0.0, 1.0, 0.0 } },     // LP_18
+    { LADDER_LINEAR, { 0.0, 0.0, 1.0, 0.0, 0.0 } },     // LP_12
+    { LADDER_LINEAR, { 1.0, -2.0, 1.0, 0.0, 0.0 } },    // HP_12
+    { LADDER_LINEAR, { 1.0, 0.0, 0.0, 0.0, 0.0 } },     // FLAT
+    { LADDER_ZERO_DELAY, { 0.0, 0.0, 0.0, 0.0, 1.0 } }, // TB_303_ZDF
+};
+inline constexpr int teeBeeNumModes = static_cast<int>(sizeof(teeBeeModeTaps) / sizeof(teeBeeModeTaps[0]));
+
+// Zero-delay diode ladder (TB_303_ZDF). The linear ladder oscillates at sqrt(2) x its stage rate
+// with a loop gain of 17; the stage gain is prewarped so that frequency lands on the cutoff
+inline constexpr double teeBeeZdfCriticalGain = 17.0;
+inline constexpr double teeBeeZdfPeakRatio = 1.41421356237309504880;
+// Ladder units per unit of the (drive-scaled) input: at 0 dB drive a full-scale input reaches the
+// diodes' knee. The output is scaled back by the same amount
+inline constexpr double teeBeeZdfLevel = 32.0;
+// Newton steps per sample after the linear solve: two come within -200 dB of the converged solve
+// at 0 dB drive and -92 dB at +48 dB (about float rounding; see the zdf_ladder test)
+inline constexpr int teeBeeZdfNewtonIterations = 2;
+
+// Per-block settings shared by every lane: filter mode and saturator tier
+struct TeeBeeKernelSetup
+{
+    int mode = 0; // TeeBeeFilter::Mode
+    int quality = QUALITY_EXACT;
+    bool ramping = false; // Apply the lane block's per-sample coefficient ramps
+    // Fixed one-pole smoothers, tuned for the host rate (see scaleToOversampling)
+    double feedbackLpPole = 0.9, feedbackLpGain = 0.1, dcBlockerPole = 0.9995;
+
+    // Keeps the one-pole corners where they are at the host rate when running `factor` x faster
+    void scaleToOversampling(int factor)
+    {
+        if (factor <= 1) return;
+        feedbackLpPole = std::pow(0.9, 1.0 / factor);
+        feedbackLpGain = 1.0 - feedbackLpPole;
+        dcBlockerPole = std::pow(0.9995, 1.0 / factor);
+    }
+};
+
+// Coefficients and state of NumLanes independent ladders. Real is the ladder's type, Wide the
+// feedback path's (double/double, float/double for mixed, float/float)
+template <int NumLanes, class RealType = double, class WideType = RealType>
+struct alignas(64) TeeBeeLaneBlock
+{
+    static constexpr int numLanes = NumLanes;
+    using Real = RealType;
+    using Wide = WideType;
+
+    // Coefficients
+    Real inputGain[NumLanes] = {}, b0[NumLanes] = {}, a1[NumLanes] = {};
+    Wide fbGain[NumLanes] = {}, hpA0[NumLanes] = {}, hpA1[NumLanes] = {}, hpB1[NumLanes] = {};
+    Real zdfG[NumLanes] = {}; // Prewarped stage gain of the zero-delay ladder
+
+    // Per-sample coefficient ramps (see TeeBeeFilter::rampTo). Cutoff, feedback HP cutoff and
+    // drive move linearly in Hz/dB, which makes a1, hpB1 and inputGain geometric sequences;
+    // zdfG moves linearly between its exact end points
+    Real inputGainRatio[NumLanes] = {}, b0Step[NumLanes] = {}, a1Ratio[NumLanes] = {}, zdfGStep[NumLanes] = {};
+    Wide fbGainStep[NumLanes] = {}, hpB1Ratio[NumLanes] = {};
+
+    // State
+    Real y1[NumLanes] = {}, y2[NumLanes] = {}, y3[NumLanes] = {};
+    Wide y4[NumLanes] = {};
+    Wide hpZ1[NumLanes] = {}, hpIn1[NumLanes] = {}, lpZ1[NumLanes] = {}; // Feedback high-pass / low-pass
+    Real dcX1[NumLanes] = {}, dcY1[NumLanes] = {}; // DC blocker
+
+    void resetLane(int lane)
+    {
+        y1[lane] = y2[lane] = y3[lane] = dcX1[lane] = dcY1[lane] = Real(0);
+        y4[lane] = hpZ1[lane] = hpIn1[lane] = lpZ1[lane] = Wide(0);
+    }
+
+    // Copies one lane (coefficients, ramps and state) to lane `to` of `dest`, which may hold
+    // another precision (values are rounded to the destination's types)
+    template <class Dest>
+    void copyLaneTo(int from, Dest& dest, int to) const
+    {
+        auto copy = [&](auto& d, const auto& s) { d[to] = static_cast<std::remove_reference_t<decltype(d[0])>>(s[from]); };
+        copy(dest.inputGain, inputGain); copy(dest.fbGain, fbGain); copy(dest.b0, b0); copy(dest.a1, a1);
+        copy(dest.hpA0, hpA0); copy(dest.hpA1, hpA1); copy(dest.hpB1, hpB1); copy(dest.zdfG, zdfG);
+        copy(dest.inputGainRatio, inputGainRatio); copy(dest.fbGainStep, fbGainStep); copy(dest.b0Step, b0Step);
+        copy(dest.a1Ratio, a1Ratio); copy(dest.hpB1Ratio, hpB1Ratio); copy(dest.zdfGStep, zdfGStep);
+        copy(dest.y1, y1); copy(dest.y2, y2); copy(dest.y3, y3); copy(dest.y4, y4);
+        copy(dest.hpZ1, hpZ1); copy(dest.hpIn1, hpIn1); copy(dest.lpZ1, lpZ1);
+        copy(dest.dcX1, dcX1); copy(dest.dcY1, dcY1);
+    }
+
+    // Largest |state| of a lane. The ladder settles near zero, not at it (y0 carries a 1e-12
+    // bias against denormals), so silence checks compare this against a threshold
+    double laneStateMagnitude(int lane) const
+    {
+        double m = 0.0;
+        for (double v : { double(y1[lane]), double(y2[lane]), double(y3[lane]), double(y4[lane]), double(hpZ1[lane]),
+                          double(hpIn1[lane]), double(lpZ1[lane]), double(dcX1[lane]), double(dcY1[lane]) })
+            m = std::fmax(m, std::fabs(v));
+        return m;
+    }
+
+    bool laneIsFinite(int lane) const
+    {
+        return std::isfinite(y1[lane]) && std::isfinite(y2[lane]) && std::isfinite(y3[lane]) && std::isfinite(y4[lane])
+            && std::isfinite(hpZ1[lane]) && std::isfinite(hpIn1[lane]) && std::isfinite(lpZ1[lane])
+            && std::isfinite(dcX1[lane]) && std::isfinite(dcY1[lane]);
+    }
+};
+
+template <int NumLanes> using TeeBeeMixedLaneBlock = TeeBeeLaneBlock<NumLanes, float, double>;
+template <int NumLanes> using TeeBeeFloatLaneBlock = TeeBeeLaneBlock<NumLanes, float, float>;
+
+// One lane: a plain double or float
+template <class Real>
+struct TeeBeeScalarOpsT
+{
+    using V = Real;
+    using T = Real;
+    using WideOps = TeeBeeScalarOpsT;
+    static constexpr int width = 1;
+
+    static V load(const T* p) { return *p; }
+    static void store(T* p, V v) { *p = v; }
+    template <class Sample> static V gather(Sample* const* channels, int i) { return static_cast<V>(channels[0][i]); }
+    template <class Sample> static void scatter(Sample* const* channels, int i, V v) { channels[0][i] = static_cast<Sample>(v); }
+    static V clip(V v, V lo, V hi) { return v < lo ? lo : (hi < v ? hi : v); }
+    static V tanh(V v) { return std::tanh(v); }
+    static V widen(V v) { return v; }
+    static V narrow(V v) { return v; }
+};
+
+using TeeBeeScalarOps = TeeBeeScalarOpsT<double>;
+
+// One lane: float ladder, double feedback path
+struct TeeBeeScalarMixedOps : TeeBeeScalarOpsT<float>
+{
+    using WideOps = TeeBeeScalarOps;
+    static double widen(float v) { return v; }
+    static float narrow(double v) { return static_cast<float>(v); }
+};
+
+// The double, float or mixed flavour of a lane type, matching a lane block's precision
+template <class Block, class DoubleOps, class FloatOps, class MixedOps>
+using TeeBeeOpsFor = std::conditional_t<std::is_same_v<typename Block::Real, double>, DoubleOps,
+                                        std::conditional_t<std::is_same_v<typename Block::Wide, double>, MixedOps, FloatOps>>;
+
+/**
+ * Weighted sum of a mode's output taps y[0..4]. Zero-weight taps are skipped and unit weights
+ * are not multiplied; the rest is added in tap order, so it rounds exactly like the full sum.
+ */
+template <int Mode, int Tap = 0, class V>
+inline V teeBeeModeTapSum(const V (&y)[5], V sum = V(0.0))
+{
+    constexpr TeeBeeModeTaps taps = teeBeeModeTaps[Mode];
+    if constexpr (Tap == 5) return sum;
+    else if constexpr (taps.c[Tap] == 0.0) return teeBeeModeTapSum<Mode, Tap + 1>(y, sum);
+    else {
+        V term = y[Tap];
+        if constexpr (taps.c[Tap] != 1.0) term = V(taps.c[Tap]) * term;
+        if constexpr (Tap == taps.firstTap()) return teeBeeModeTapSum<Mode, Tap + 1>(y, term);
+        else return teeBeeModeTapSum<Mode, Tap + 1>(y, sum + term);
+    }
+}
+
+/**
+ * Runs numSamples through Ops::width lanes of a lane block, starting at `lane`.
+ * channels[l] is the in/out buffer of lane (lane + l), float or double. State is loaded into
+ * locals for the whole loop and written back at the end; the caller handles denormals and
+ * the non-finite guard. With isRamping, the coefficients step once per sample (before it is
+ * processed) and the final values are written back as well.
+ */
+template <class Ops, class Sat, int Mode, bool isRamping, class Block, class Sample>
+inline void teeBeeProcessLanes(Block& b, int lane, const TeeBeeKernelSetup& setup,
+                               Sample* const* channels, int numSamples)
+{
+    constexpr bool isTB303 = teeBeeModeTaps[Mode].ladder == LADDER_TB303;
+    using V = typename Ops::V;
+    using W = typename Ops::WideOps; // Feedback path
+    using WV = typename W::V;
+    const V lo2 = V(-2.0), hi2 = V(2.0), lo6 = V(-6.0), hi6 = V(6.0);
+    const WV wideLo2 = WV(-2.0), wideHi2 = WV(2.0);
+    auto clip = [&](V v) { return Ops::clip(v, lo2, hi2); };
+    auto clipWide = [&](WV v) { return W::clip(v, wideLo2, wideHi2); };
+    auto softClip = [&](V x) { return Sat::template apply<Ops>(Ops::clip(x, lo6, hi6)); };
+
+    V inputGain = Ops::load(b.inputGain + lane);
+    WV fbGain = W::load(b.fbGain + lane);
+    V fbGainMode = Ops::narrow(isTB303 ? fbGain : fbGain * WV(0.7));
+    WV hpA0 = W::load(b.hpA0 + lane), hpA1 = W::load(b.hpA1 + lane), hpB1 = W::load(b.hpB1 + lane);
+    V g0 = Ops::load(b.b0 + lane), p1 = Ops::load(b.a1 + lane);
+    V inputGainRatio = V(1.0), b0Step = V(0.0), a1Ratio = V(1.0);
+    WV fbGainStep = WV(0.0), hpB1Ratio = WV(1.0);
+    if constexpr (isRamping) {
+        inputGainRatio = Ops::load(b.inputGainRatio + lane);
+        fbGainStep = W::load(b.fbGainStep + lane);
+        b0Step = Ops::load(b.b0Step + lane);
+        a1Ratio = Ops::load(b.a1Ratio + lane);
+        hpB1Ratio = W::load(b.hpB1Ratio + lane);
+    }
+    const WV lpPole = WV(setup.feedbackLpPole), lpGain = WV(setup.feedbackLpGain);
+    const V bias = V(1e-12), outGain = V(0.8), outMakeup = V(1.25), tapGain = V(5.0);
+    const V R = V(setup.dcBlockerPole); // DC blocker, 10 Hz @ 44.1 kHz
+    V s1 = Ops::load(b.y1 + lane), s2 = Ops::load(b.y2 + lane), s3 = Ops::load(b.y3 + lane);
+    WV s4 = W::load(b.y4 + lane);
+    WV hpZ1 = W::load(b.hpZ1 + lane), hpIn1 = W::load(b.hpIn1 + lane), lpZ1 = W::load(b.lpZ1 + lane);
+    V dcX1 = Ops::load(b.dcX1 + lane), dcY1 = Ops::load(b.dcY1 + lane);
+
+    for (int i = 0; i < numSamples; ++i) {
+        if constexpr (isRamping) {
+            inputGain = inputGain * inputGainRatio;
+            fbGain = fbGain + fbGainStep;
+            fbGainMode = Ops::narrow(isTB303 ? fbGain : fbGain * WV(0.7));
+            g0 = g0 + b0Step;
+            p1 = p1 * a1Ratio;
+            hpB1 = hpB1 * hpB1Ratio; // hpB1 = -x, hpA0 = 1 + x, hpA1 = -(1 + x)
+            hpA0 = WV(1.0) - hpB1;
+            hpA1 = WV(0.0) - hpA0;
+        }
+        const V input = clip(inputGain * Ops::gather(channels, i));
+        WV fb = fbGain * s4;
+        lpZ1 = lpPole * lpZ1 + lpGain * fb;
+        fb = clipWide(lpZ1);
+        const WV hp = hpA0 * fb + hpA1 * hpIn1 - hpB1 * hpZ1;
+        hpIn1 = fb;
+        hpZ1 = clipWide(hp);
+        V y0 = input - Ops::narrow(hp);
+        y0 = y0 + bias;
+        y0 = y0 - fbGainMode * Ops::narrow(s4);
+        V out;
+        if constexpr (isTB303) {
+            s1 = s1 + g0 * (softClip(y0) - softClip(s1));
+            s2 = s2 + g0 * (softClip(s1) - softClip(s2));
+            s3 = s3 + g0 * (softClip(s2) - softClip(s3));
+            s4 = s4 + Ops::widen(g0 * (softClip(s3) - softClip(Ops::narrow(s4))));
+            s1 = clip(s1);
+            s2 = clip(s2);
+            s3 = clip(s3);
+            s4 = clipWide(s4);
+            out = Ops::narrow(s4);
+        }
+        else {
+            s1 = y0 + p1 * (y0 - s1);
+            s2 = s1 + p1 * (s1 - s2);
+            s3 = s2 + p1 * (s2 - s3);
+            const WV s3Wide = Ops::widen(s3);
+            s4 = s3Wide + Ops::widen(p1) * (s3Wide - s4);
+            s1 = clip(s1);
+            s2 = clip(s2);
+            s3 = clip(s3);
+            s4 = clipWide(s4);
+            const V taps[5] = { y0, s1, s2, s3, Ops::narrow(s4) };
+            out = tapGain * teeBeeModeTapSum<Mode>(taps);
+        }
+        out = clip(softClip(out * outGain) * outMakeup);
+        const V dc = out - dcX1 + R * dcY1;
+        dcX1 = out;
+        dcY1 = dc;
+        Ops::scatter(channels, i, dc);
+    }
+
+    Ops::store(b.y1 + lane, s1); Ops::store(b.y2 + lane, s2); Ops::store(b.y3 + lane, s3); W::store(b.y4 + lane, s4);
+    W::store(b.hpZ1 + lane, hpZ1); W::store(b.hpIn1 + lane, hpIn1); W::store(b.lpZ1 + lane, lpZ1);
+    Ops::store(b.dcX1 + lane, dcX1); Ops::store(b.dcY1 + lane, dcY1);
+    if constexpr (isRamping) {
+        Ops::store(b.inputGain + lane, inputGain); W::store(b.fbGain + lane, fbGain);
+        Ops::store(b.b0 + lane, g0); Ops::store(b.a1 + lane, p1);
+        W::store(b.hpA0 + lane, hpA0); W::store(b.hpA1 + lane, hpA1); W::store(b.hpB1 + lane, hpB1);
+    }
+}
+
+/**
+ * TB_303_ZDF: the TB-303's diode ladder without a unit delay anywhere in the loop. Each stage
+ * capacitor integrates the difference of the tanh currents through the diode pairs below and
+ * above it (the top one, of half the capacitance, twice its current):
+ *   y1' = w (t0 - t1), y2' = w (t1 - t2), y3' = w (t2 - t3), y4' = 2w t3,
+ *   t0 = tanh(u - y1), tn = tanh(yn - yn+1), u = input - k HP(y4)
+ * Trapezoidal (TPT) integrators make that four implicit equations per sample, solved together with
+ * the feedback high-pass: first linearly (every tanh' = 1), then teeBeeZdfNewtonIterations Newton
+ * steps on the full equations. The Jacobian is tridiagonal apart from the feedback term, so each
+ * step is one forward sweep that carries y4 along and one back substitution: 4 tanh, 4 divisions.
+ * The fixed step count keeps the cost per sample constant and the lanes in step.
+ * Runs in the ladder's type throughout (also the feedback path in Mixed precision).
+ */
+template <class Ops, class Sat, bool isRamping, class Block, class Sample>
+inline void teeBeeProcessZdfLanes(Block& b, int lane, const TeeBeeKernelSetup& setup,
+                                  Sample* const* channels, int numSamples)
+{
+    using V = typename Ops::V;
+    using W = typename Ops::WideOps;
+    using WV = typename W::V;
+    const V lo2 = V(-2.0), hi2 = V(2.0), lo6 = V(-6.0), hi6 = V(6.0);
+    auto clip = [&](V v) { return Ops::clip(v, lo2, hi2); };
+    auto softClip = [&](V x) { return Sat::template apply<Ops>(Ops::clip(x, lo6, hi6)); };
+
+    V inputGain = Ops::load(b.inputGain + lane), g = Ops::load(b.zdfG + lane);
+    WV fbGain = W::load(b.fbGain + lane), hpB1 = W::load(b.hpB1 + lane);
+    V inputGainRatio = V(1.0), gStep = V(0.0);
+    WV fbGainStep = WV(0.0), hpB1Ratio = WV(1.0);
+    if constexpr (isRamping) {
+        inputGainRatio = Ops::load(b.inputGainRatio + lane);
+        gStep = Ops::load(b.zdfGStep + lane);
+        fbGainStep = W::load(b.fbGainStep + lane);
+        hpB1Ratio = W::load(b.hpB1Ratio + lane);
+    }
+    const V one = V(1.0), two = V(2.0), half = V(0.5), bias = V(1e-12), outGain = V(0.8), outMakeup = V(1.25);
+    const V level = V(teeBeeZdfLevel), outLevel = V(1.0 / teeBeeZdfLevel);
+    const V R = V(setup.dcBlockerPole);
+    // Integrator states; y4's and the high-pass's are kept in the feedback path's type between blocks
+    V s1 = Ops::load(b.y1 + lane), s2 = Ops::load(b.y2 + lane), s3 = Ops::load(b.y3 + lane);
+    V s4 = Ops::narrow(W::load(b.y4 + lane)), sHp = Ops::narrow(W::load(b.hpZ1 + lane));
+    V dcX1 = Ops::load(b.dcX1 + lane), dcY1 = Ops::load(b.dcY1 + lane);
+
+    // Solves J d = r for the Jacobian with tanh' = D0..D3; c is the loop gain through the
+    // high-pass, so row 1 also depends on y4
+    auto solve = [&](V c, V D0, V D1, V D2, V D3, V r1, V r2, V r3, V r4, V& d1, V& d2, V& d3, V& d4) {
+        const V gD1 = g * D1, gD2 = g * D2, gD3 = g * D3;
+        const V a1 = one + g * D0 + gD1;
+        const V p1 = r1 / a1, q1 = gD1 / a1, w1 = V(0.0) - g * D0 * c / a1;
+        const V a2 = one + gD1 + gD2 - gD1 * q1;
+        const V p2 = (r2 + gD1 * p1) / a2, q2 = gD2 / a2, w2 = gD1 * w1 / a2;
+        const V a3 = one + gD2 + gD3 - gD2 * q2;
+        const V p3 = (r3 + gD2 * p2) / a3, w3 = (gD3 + gD2 * w2) / a3;
+        const V gD3x2 = two * gD3;
+        d4 = (r4 + gD3x2 * p3) / (one + gD3x2 - gD3x2 * w3);
+        d3 = p3 + w3 * d4;
+        d2 = p2 + q2 * d3 + w2 * d4;
+        d1 = p1 + q1 * d2 + w1 * d4;
+    };
+
+    for (int i = 0; i < numSamples; ++i) {
+        if constexpr (isRamping) {
+            inputGain = inputGain * inputGainRatio;
+            g = g + gStep;
+            fbGain = fbGain + fbGainStep;
+            hpB1 = hpB1 * hpB1Ratio;
+        }
+        // The feedback high-pass as a TPT one-pole with the same pole: hp = (y4 - sHp) (1 + hpB1) / 2
+        const V c = Ops::narrow(fbGain) * half * (one - Ops::narrow(hpB1));
+        const V x = level * clip(inputGain * Ops::gather(channels, i)) + bias;
+        const V u0 = x + c * sHp; // u = u0 - c y4
+
+        // Linear solve: the exact answer for small signals, and where Newton starts
+        V y1, y2, y3, y4;
+        solve(c, one, one, one, one, s1 + g * u0, s2, s3, s4, y1, y2, y3, y4);
+        for (int n = 0; n < teeBeeZdfNewtonIterations; ++n) {
+            const V t0 = softClip(u0 - c * y4 - y1), t1 = softClip(y1 - y2), t2 = softClip(y2 - y3), t3 = softClip(y3 - y4);
+            const V f1 = y1 - s1 - g * (t0 - t1), f2 = y2 - s2 - g * (t1 - t2);
+            const V f3 = y3 - s3 - g * (t2 - t3), f4 = y4 - s4 - two * g * t3;
+            V d1, d2, d3, d4;
+            solve(c, one - t0 * t0, one - t1 * t1, one - t2 * t2, one - t3 * t3, V(0.0) - f1, V(0.0) - f2, V(0.0) - f3,
+                  V(0.0) - f4, d1, d2, d3, d4);
+            y1 = y1 + d1;
+            y2 = y2 + d2;
+            y3 = y3 + d3;
+            y4 = y4 + d4;
+        }
+        s1 = two * y1 - s1;
+        s2 = two * y2 - s2;
+        s3 = two * y3 - s3;
+        s4 = two * y4 - s4;
+        const V lp = y4 - (y4 - sHp) * half * (one - Ops::narrow(hpB1));
+        sHp = two * lp - sHp;
+
+        V out = y4 * outLevel;
+        out = clip(softClip(out * outGain) * outMakeup);
+        const V dc = out - dcX1 + R * dcY1;
+        dcX1 = out;
+        dcY1 = dc;
+        Ops::scatter(channels, i, dc);
+    }
+
+    Ops::store(b.y1 + lane, s1); Ops::store(b.y2 + lane, s2); Ops::store(b.y3 + lane, s3);
+    W::store(b.y4 + lane, Ops::widen(s4)); W::store(b.hpZ1 + lane, Ops::widen(sHp));
+    Ops::store(b.dcX1 + lane, dcX1); Ops::store(b.dcY1 + lane, dcY1);
+    if constexpr (isRamping) {
+        const WV hpA0 = WV(1.0) - hpB1;
+        Ops::store(b.inputGain + lane, inputGain); Ops::store(b.zdfG + lane, g); W::store(b.fbGain + lane, fbGain);
+        W::store(b.hpA0 + lane, hpA0); W::store(b.hpA1 + lane, WV(0.0) - hpA0); W::store(b.hpB1 + lane, hpB1);
+    }
+}
+
+/**
+ * Mode-change crossfade: mixes the old mode's output `from` into `to` over the next numSamples
+ * of a linear fade with `remaining` of `length` samples left. The fade ends exactly on `to`.
+ */
+template <class Sample>
+inline void teeBeeCrossfade(const Sample* from, Sample* to, int numSamples, int remaining, int length)
+{
+    const double step = 1.0 / length;
+    for (int i = 0; i < numSamples; ++i) {
+        const double fromGain = (remaining - i - 1) * step;
+        to[i] = static_cast<Sample>(to[i] + fromGain * (from[i] - to[i]));
+    }
+}
+
+template <class Block, class Sample>
+using TeeBeeLaneKernel = void (*)(Block&, int lane, const TeeBeeKernelSetup&, Sample* const* channels, int numSamples);
+
+// One kernel per mode and ramping flag, for a lane type and saturator
+template <class Ops, class Sat, class Block, class Sample>
+struct TeeBeeLaneKernelTable
+{
+    template <int Mode, bool isRamping>
+    static constexpr TeeBeeLaneKernel<Block, Sample> pick()
+    {
+        if constexpr (teeBeeModeTaps[Mode].ladder == LADDER_ZERO_DELAY) return &teeBeeProcessZdfLanes<Ops, Sat, isRamping, Block, Sample>;
+        else return &teeBeeProcessLanes<Ops, Sat, Mode, isRamping, Block, Sample>;
+    }
+
+    template <int Mode, bool isRamping>
+    static constexpr TeeBeeLaneKernel<Block, Sample> kernel = pick<Mode, isRamping>();
+
+    template <int... Modes>
+    static constexpr auto make(std::integer_sequence<int, Modes...>)
+    {
+        return std::array<std::array<TeeBeeLaneKernel<Block, Sample>, 2>, sizeof...(Modes)> {
+            { { kernel<Modes, false>, kernel<Modes, true> }... }
+        };
+    }
+
+    static constexpr auto kernels = make(std::make_integer_sequence<int, teeBeeNumModes>{});
+};
+
+// Runtime dispatch of teeBeeProcessLanes on the setup's mode and ramping
+template <class Ops, class Sat, class Block, class Sample>
+inline void teeBeeProcessLanesWith(const TeeBeeKernelSetup& setup, Block& b, int lane,
+                                   Sample* const* channels, int numSamples)
+{
+    const auto& kernels = TeeBeeLaneKernelTable<Ops, Sat, Block, Sample>::kernels;
+    kernels[static_cast<size_t>(setup.mode)][setup.ramping ? 1 : 0](b, lane, setup, channels, numSamples);
+}
+
+template <class Ops, class Block, class Sample>
+inline void teeBeeProcessLanes(const TeeBeeKernelSetup& setup, Block& b, int lane,
+                               Sample* const* channels, int numSamples)
+{
+    switch (setup.quality) {
+    case QUALITY_TABLE: teeBeeProcessLanesWith<Ops, TeeBeeTanhTable>(setup, b, lane, channels, numSamples); break;
+    case QUALITY_PADE: teeBeeProcessLanesWith<Ops, TeeBeeTanhPade>(setup, b, lane, channels, numSamples); break;
+    default: teeBeeProcessLanesWith<Ops, TeeBeeTanhExact>(setup, b, lane, channels, numSamples); break;
+    }
+}
+
+#endif // TEEBEE_KERNEL_H_INCLUDED
@@ -0,0 +1,19 @@
+// AVX2 instantiation of the ladder kernel. Built with AVX2 code generation enabled (see CMakeLists.txt)
+// and only called after TeeBeeMultiChannelFilter has checked the CPU supports it.
+// Keep this file free of other inline code: anything it instantiates is compiled for AVX2.
+
+#include "TeeBeeSimdOps.h"
+
+#if !(defined(__AVX2__))
+#error "TeeBeeKernelAVX2.cpp must be compiled with AVX2 enabled"
+#endif
+
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockAVX2(Block& b, int activeLanes, const TeeBeeKernelSetup& setup,
+                                Sample* const* channels, int numSamples)
+{
+    using Ops = TeeBeeOpsFor<Block, TeeBeeAvx2Ops, TeeBeeAvx2FloatOps, TeeBeeAvx2MixedOps>;
+    teeBeeProcessLaneBlock<Ops>(b, activeLanes, setup, channels, numSamples);
+}
+
+TEEBEE_INSTANTIATE_LANE_BLOCK_KERNELS(teeBeeProcessLaneBlockAVX2)
@@ -0,0 +1,19 @@
+// AVX512 instantiation of the ladder kernel. Built with AVX512 code generation enabled (see CMakeLists.txt)
+// and only called after TeeBeeMultiChannelFilter has checked the CPU supports it.
+// Keep this file free of other inline code: anything it instantiates is compiled for AVX512.
+
+#include "TeeBeeSimdOps.h"
+
+#if !(defined(__AVX512F__))
+#error "TeeBeeKernelAVX512.cpp must be compiled with AVX512 enabled"
+#endif
+
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockAVX512(Block& b, int activeLanes, const TeeBeeKernelSetup& setup,
+                                  Sample* const* channels, int numSamples)
+{
+    using Ops = TeeBeeOpsFor<Block, TeeBeeAvx512Ops, TeeBeeAvx512FloatOps, TeeBeeAvx512MixedOps>;
+    teeBeeProcessLaneBlock<Ops>(b, activeLanes, setup, channels, numSamples);
+}
+
+TEEBEE_INSTANTIATE_LANE_BLOCK_KERNELS(teeBeeProcessLaneBlockAVX512)
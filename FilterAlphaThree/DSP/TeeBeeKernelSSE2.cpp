@@ -0,0 +1,19 @@
+// SSE2 instantiation of the ladder kernel. Built with SSE2 code generation enabled (see CMakeLists.txt)
+// and only called after TeeBeeMultiChannelFilter has checked the CPU supports it.
+// Keep this file free of other inline code: anything it instantiates is compiled for SSE2.
+
+#include "TeeBeeSimdOps.h"
+
+#if !(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#error "TeeBeeKernelSSE2.cpp must be compiled with SSE2 enabled"
+#endif
+
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockSSE2(Block& b, int activeLanes, const TeeBeeKernelSetup& setup,
+                                Sample* const* channels, int numSamples)
+{
+    using Ops = TeeBeeOpsFor<Block, TeeBeeSse2Ops, TeeBeeSse2FloatOps, TeeBeeSse2MixedOps>;
+    teeBeeProcessLaneBlock<Ops>(b, activeLanes, setup, channels, numSamples);
+}
+
+TEEBEE_INSTANTIATE_LANE_BLOCK_KERNELS(teeBeeProcessLaneBlockSSE2)
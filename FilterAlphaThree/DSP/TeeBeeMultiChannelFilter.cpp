@@ -0,0 +1,581 @@
+#include "TeeBeeMultiChannelFilter.h"
+#include "TeeBeeSimdOps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// CPU Detection
+namespace
+{
+bool cpuHasAvx2()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAvx512()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    const bool osSavesZmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0xE6) == 0xE6;
+    __cpuidex(info, 7, 0);
+    return osSavesZmm && (info[1] & (1 << 16)) != 0;
+#else
+    return false;
+#endif
+}
+
+// Samples the ladder's input guard will clip (|inputGain * x| > 2), stepping the gain like the
+// kernel does while ramping; every lane has the same gain
+template <class Block, class Sample>
+std::uint32_t countInputClips(const Block& block, bool ramping, const Sample* const* channels, int numActive,
+                              int offset, int numSamples)
+{
+    const double ratio = ramping ? static_cast<double>(block.inputGainRatio[0]) : 1.0;
+    std::uint32_t clipped = 0;
+    for (int c = 0; c < numActive; ++c) {
+        double gain = block.inputGain[0];
+        for (int i = 0; i < numSamples; ++i) {
+            gain *= ratio;
+            clipped += std::abs(gain * channels[c][offset + i]) > 2.0 ? 1u : 0u;
+        }
+    }
+    return clipped;
+}
+
+template <class Sample>
+Sample peakLevel(const Sample* const* channels, int numChannels, int numSamples)
+{
+    Sample peak = 0;
+    for (int c = 0; c < numChannels; ++c)
+        for (int i = 0; i < numSamples; ++i) peak = std::max(peak, std::abs(channels[c][i]));
+    return peak;
+}
+} // namespace
+
+TeeBeeMultiChannelFilter::Isa TeeBeeMultiChannelFilter::detectIsa()
+{
+#if defined(TEEBEE_HAVE_AVX512_KERNEL)
+    if (cpuHasAvx512()) return Isa::AVX512;
+#endif
+#if defined(TEEBEE_HAVE_AVX2_KERNEL)
+    if (cpuHasAvx2()) return Isa::AVX2;
+#endif
+#if defined(TEEBEE_HAVE_SSE2_KERNEL)
+    return Isa::SSE2;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+const char* TeeBeeMultiChannelFilter::getIsaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::SSE2: return "SSE2";
+    case Isa::AVX2: return "AVX2";
+    case Isa::AVX512: return "AVX-512";
+    default: return "Scalar";
+    }
+}
+
+// Engine
+TeeBeeMultiChannelFilter::TeeBeeMultiChannelFilter()
+    : isa(detectIsa())
+{
+}
+
+TeeBeeMultiChannelFilter::Isa TeeBeeMultiChannelFilter::setMaxIsa(Isa maxIsa)
+{
+    isa = std::min(maxIsa, detectIsa());
+    return isa;
+}
+
+void TeeBeeMultiChannelFilter::prepare(int newNumChannels, double sampleRate, int newMaxBlockSize)
+{
+    numChannels = std::max(0, newNumChannels);
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    blocks.assign(static_cast<size_t>((numChannels + lanesPerBlock - 1) / lanesPerBlock), LaneBlock{});
+    mixedBlocks.assign(static_cast<size_t>((numChannels + MixedLaneBlock::numLanes - 1) / MixedLaneBlock::numLanes), MixedLaneBlock{});
+    floatBlocks.assign(static_cast<size_t>((numChannels + FloatLaneBlock::numLanes - 1) / FloatLaneBlock::numLanes), FloatLaneBlock{});
+    scratch.assign(static_cast<size_t>(maxBlockSize) * TeeBeeOversampler::maxFactor, 0.0f);
+    doubleScratch.assign(scratch.size(), 0.0);
+    fadeBlocks.assign(blocks.size(), LaneBlock{});
+    mixedFadeBlocks.assign(mixedBlocks.size(), MixedLaneBlock{});
+    floatFadeBlocks.assign(floatBlocks.size(), FloatLaneBlock{});
+    fadeScratch.assign(static_cast<size_t>(numChannels) * TeeBeeFilter::modeFadeChunk, 0.0f);
+    doubleFadeScratch.assign(fadeScratch.size(), 0.0);
+    floatChannelsAt.assign(static_cast<size_t>(numChannels), nullptr);
+    doubleChannelsAt.assign(static_cast<size_t>(numChannels), nullptr);
+    modulationPhase = 0;
+    lastModulation = 0.0f;
+    modulated = false;
+    model.setSampleRate(sampleRate);
+    hostSampleRate = model.sampleRate;
+    // Fetch the tables of every oversampled rate now, so setOversampling() never allocates
+    for (int s = 0; s <= TeeBeeOversampler::maxStages; ++s)
+        coefficientTables[s] = TeeBeeCoefficientTable::forSampleRate(hostSampleRate * (1 << s));
+
+    const int factor = oversampler.getFactor();
+    oversampler.prepare(numChannels, maxBlockSize);
+    oversampler.setup(1, oversampler.getPhase());
+    model.setCoefficientTable(coefficientTables[0].get());
+    setParameters(TeeBeeParameters{});
+    setOversampling(factor, oversampler.getPhase());
+    reset();
+}
+
+void TeeBeeMultiChannelFilter::setOversampling(int factor, TeeBeeOversampler::Phase phase)
+{
+    int stages = 0;
+    while (stages < TeeBeeOversampler::maxStages && (1 << stages) < factor) ++stages;
+    if ((1 << stages) == oversampler.getFactor() && phase == oversampler.getPhase()) return;
+
+    oversampler.setup(1 << stages, phase);
+    model.setSampleRate(hostSampleRate * (1 << stages));
+    model.setCoefficientTable(coefficientTables[stages].get());
+    setCoefficients(current);
+    reset();
+}
+
+template <class F>
+void TeeBeeMultiChannelFilter::visitBlocks(F&& f)
+{
+    switch (precision) {
+    case PRECISION_MIXED: f(mixedBlocks); break;
+    case PRECISION_FLOAT: f(floatBlocks); break;
+    default: f(blocks); break;
+    }
+}
+
+void TeeBeeMultiChannelFilter::setPrecision(int newPrecision)
+{
+    newPrecision = std::clamp(newPrecision, 0, NUM_PRECISIONS - 1);
+    if (newPrecision == precision) return;
+    fadeRemaining = 0;
+
+    // Every lane of the new blocks gets a channel's coefficients, ramp and state; lanes past the
+    // last channel copy the last channel, so they hold valid values too
+    visitBlocks([&](auto& from) {
+        precision = newPrecision;
+        visitBlocks([&](auto& to) {
+            constexpr int fromLanes = std::decay_t<decltype(from[0])>::numLanes;
+            constexpr int toLanes = std::decay_t<decltype(to[0])>::numLanes;
+            const int numLanes = static_cast<int>(to.size()) * toLanes;
+            for (int c = 0; c < numLanes; ++c) {
+                const int source = std::min(c, numChannels - 1);
+                from[static_cast<size_t>(source / fromLanes)].copyLaneTo(source % fromLanes, to[static_cast<size_t>(c / toLanes)], c % toLanes);
+            }
+        });
+    });
+}
+
+void TeeBeeMultiChannelFilter::reset()
+{
+    visitBlocks([](auto& laneBlocks) {
+        for (auto& block : laneBlocks)
+            for (int lane = 0; lane < block.numLanes; ++lane)
+                block.resetLane(lane);
+    });
+    oversampler.reset();
+    fadeRemaining = 0;
+    quietSamples = 0;
+    idle = false;
+}
+
+template <class Block>
+std::vector<Block>& TeeBeeMultiChannelFilter::fadeBlocksFor()
+{
+    if constexpr (std::is_same_v<Block, LaneBlock>) return fadeBlocks;
+    else if constexpr (std::is_same_v<Block, MixedLaneBlock>) return mixedFadeBlocks;
+    else return floatFadeBlocks;
+}
+
+void TeeBeeMultiChannelFilter::startModeFade()
+{
+    fadeRemaining = 0;
+    visitBlocks([&](auto& laneBlocks) {
+        using Block = std::decay_t<decltype(laneBlocks[0])>;
+        // Lanes at rest have nothing to click
+        bool running = false;
+        for (int c = 0; c < numChannels && !running; ++c)
+            running = laneBlocks[static_cast<size_t>(c / Block::numLanes)].laneStateMagnitude(c % Block::numLanes) > 0.0;
+        if (!running) return;
+        std::copy(laneBlocks.begin(), laneBlocks.end(), fadeBlocksFor<Block>().begin());
+        fadeSetup = model.getKernelSetup();
+        fadeSetup.scaleToOversampling(oversampler.getFactor());
+        fadeLength = std::max(1, static_cast<int>(TeeBeeFilter::modeFadeSeconds * model.sampleRate + 0.5));
+        fadeRemaining = fadeLength;
+    });
+}
+
+void TeeBeeMultiChannelFilter::setParameters(const TeeBeeParameters& params)
+{
+    base = baseFrom = params;
+    baseRampLength = baseRampDone = 0;
+    // While modulated, the next modulation segment glides the coefficients there; a mode change
+    // crossfades at once, to the modulated values
+    if (!modulated) setCoefficients(params);
+    else if (params.mode != current.mode) setCoefficients(teeBeeModulate(params, modulationDepth, lastModulation));
+}
+
+void TeeBeeMultiChannelFilter::rampParameters(const TeeBeeParameters& params, int numSamples)
+{
+    if (numSamples <= 0 || params.mode != current.mode) {
+        setParameters(params);
+        return;
+    }
+    baseFrom = base;
+    base = params;
+    baseRampLength = numSamples;
+    baseRampDone = 0;
+    if (!modulated) rampCoefficients(params, numSamples);
+}
+
+TeeBeeParameters TeeBeeMultiChannelFilter::baseAt(int elapsed) const
+{
+    if (elapsed >= baseRampLength) return base;
+    const double t = static_cast<double>(elapsed) / baseRampLength;
+    TeeBeeParameters params = base;
+    params.cutoff = baseFrom.cutoff + (base.cutoff - baseFrom.cutoff) * t;
+    params.resonance = baseFrom.resonance + (base.resonance - baseFrom.resonance) * t;
+    params.drive = baseFrom.drive + (base.drive - baseFrom.drive) * t;
+    params.fbHp = baseFrom.fbHp + (base.fbHp - baseFrom.fbHp) * t;
+    params.fbAmp = baseFrom.fbAmp + (base.fbAmp - baseFrom.fbAmp) * t;
+    return params;
+}
+
+void TeeBeeMultiChannelFilter::setCoefficients(const TeeBeeParameters& params)
+{
+    if (params.mode != current.mode) startModeFade();
+    current = params;
+    rampRemaining = 0;
+    params.applyTo(model);
+    visitBlocks([&](auto& laneBlocks) {
+        for (auto& block : laneBlocks)
+            for (int lane = 0; lane < block.numLanes; ++lane)
+                model.copyCoefficientsTo(block, lane);
+    });
+}
+
+void TeeBeeMultiChannelFilter::rampCoefficients(const TeeBeeParameters& params, int numSamples)
+{
+    if (numSamples <= 0 || params.mode != current.mode) {
+        setCoefficients(params);
+        return;
+    }
+    if (rampRemaining > 0) setCoefficients(current);
+
+    // The model only computes the steps; the lanes carry the ramped coefficients
+    numSamples *= oversampler.getFactor();
+    params.rampTo(model, numSamples);
+    model.discardRamp();
+    visitBlocks([&](auto& laneBlocks) {
+        for (auto& block : laneBlocks)
+            for (int lane = 0; lane < block.numLanes; ++lane)
+                model.copyRampTo(block, lane);
+    });
+    current = params;
+    rampRemaining = numSamples;
+}
+
+void TeeBeeMultiChannelFilter::process(float* const* channels, int numBufferChannels, int numSamples)
+{
+    processAutomatedAny(channels, std::min(numChannels, numBufferChannels), numSamples, nullptr, 0, nullptr, {});
+}
+
+void TeeBeeMultiChannelFilter::process(double* const* channels, int numBufferChannels, int numSamples)
+{
+    processAutomatedAny(channels, std::min(numChannels, numBufferChannels), numSamples, nullptr, 0, nullptr, {});
+}
+
+void TeeBeeMultiChannelFilter::processAutomated(float* const* channels, int numBufferChannels, int numSamples,
+                                                const TeeBeeParameterEvent* events, int numEvents, const float* modulation,
+                                                const TeeBeeModulationDepth& depth)
+{
+    processAutomatedAny(channels, std::min(numChannels, numBufferChannels), numSamples, events, numEvents, modulation, depth);
+}
+
+void TeeBeeMultiChannelFilter::processAutomated(double* const* channels, int numBufferChannels, int numSamples,
+                                                const TeeBeeParameterEvent* events, int numEvents, const float* modulation,
+                                                const TeeBeeModulationDepth& depth)
+{
+    processAutomatedAny(channels, std::min(numChannels, numBufferChannels), numSamples, events, numEvents, modulation, depth);
+}
+
+template <class Sample>
+void TeeBeeMultiChannelFilter::processAutomatedAny(Sample* const* channels, int numActive, int numSamples,
+                                                   const TeeBeeParameterEvent* events, int numEvents,
+                                                   const float* modulation, const TeeBeeModulationDepth& depth)
+{
+    if (numSamples <= 0 || numActive <= 0) return;
+    // While modulated, points and glides only move `base`; the modulation segments move the coefficients
+    if (modulation != nullptr) {
+        modulated = true;
+        modulationDepth = depth;
+    }
+    if (numEvents > 0 && baseRampDone < baseRampLength) setParameters(base);
+
+    for (int position = 0, next = 0;;) {
+        // Points at this position: reached by the glide before, or taken at once at the block's start.
+        // The coefficients are recomputed from the exact values, so the glides' rounding never adds up
+        if (next < numEvents && events[next].offset <= position) {
+            TeeBeeParameters reached = base;
+            for (; next < numEvents && events[next].offset <= position; ++next) {
+                const auto& event = events[next];
+                if (event.parameter == PARAM_MODE)
+                    reached.mode = std::clamp(static_cast<int>(event.value), 0, TeeBeeFilter::NUM_MODES - 1);
+                else if (double* value = teeBeeContinuousParameter(reached, event.parameter))
+                    *value = event.value;
+            }
+            setParameters(reached);
+        }
+        if (position >= numSamples) break;
+
+        // Up to the next point, every parameter with a later point in this block glides towards it
+        const int split = next < numEvents ? std::min(events[next].offset, numSamples) : numSamples;
+        const int length = split - position;
+        if (next < numEvents) {
+            TeeBeeParameters target = base;
+            for (int parameter : { PARAM_CUTOFF, PARAM_RESONANCE, PARAM_DRIVE, PARAM_FB_HP, PARAM_FB_AMP }) {
+                for (int e = next; e < numEvents; ++e) {
+                    if (events[e].parameter != parameter) continue;
+                    double* value = teeBeeContinuousParameter(target, parameter);
+                    const int offset = std::min(events[e].offset, numSamples);
+                    *value += (events[e].value - *value) * length / (offset - position);
+                    break;
+                }
+            }
+            if (target != base) rampParameters(target, length);
+        }
+        if (modulation != nullptr) processModulated(channels, numActive, position, length, modulation, depth);
+        else processUnmodulated(channels, numActive, position, length);
+        position = split;
+    }
+}
+
+template <class Sample>
+void TeeBeeMultiChannelFilter::processUnmodulated(Sample* const* channels, int numActive, int offset, int numSamples)
+{
+    if (modulated) {
+        // Back from modulation: glide to where the unmodulated parameters are heading
+        modulated = false;
+        rampCoefficients(base, baseRampDone < baseRampLength ? baseRampLength - baseRampDone : modulationSegment);
+    }
+    processAny(channelsAt(channels, numActive, offset), numActive, numSamples);
+    baseRampDone = std::min(baseRampDone + numSamples, baseRampLength);
+}
+
+template <class Sample>
+void TeeBeeMultiChannelFilter::processModulated(Sample* const* channels, int numActive, int offset, int numSamples,
+                                                const float* modulation, const TeeBeeModulationDepth& depth)
+{
+    for (int end = offset + numSamples, n = 0; offset < end; offset += n) {
+        // Each segment glides to the values at the end of the one before: a segment of latency, but
+        // the same glides wherever the blocks begin (a glide carries on into the next block)
+        if (modulationPhase == 0) {
+            const auto target = teeBeeModulate(baseAt(baseRampDone), depth, lastModulation);
+            if (target != current) rampCoefficients(target, modulationSegment);
+        }
+        n = std::min(modulationSegment - modulationPhase, end - offset);
+        processAny(channelsAt(channels, numActive, offset), numActive, n);
+        modulationPhase = (modulationPhase + n) % modulationSegment;
+        baseRampDone = std::min(baseRampDone + n, baseRampLength);
+        lastModulation = modulation[offset + n - 1];
+    }
+}
+
+template <class Sample>
+Sample* const* TeeBeeMultiChannelFilter::channelsAt(Sample* const* channels, int numActive, int offset)
+{
+    if (offset == 0) return channels;
+    auto& pointers = [this]() -> std::vector<Sample*>& {
+        if constexpr (std::is_same_v<Sample, float>) return floatChannelsAt;
+        else return doubleChannelsAt;
+    }();
+    for (int c = 0; c < numActive; ++c) pointers[static_cast<size_t>(c)] = channels[c] + offset;
+    return pointers.data();
+}
+
+template <class Sample>
+void TeeBeeMultiChannelFilter::processAny(Sample* const* channels, int numActive, int numSamples)
+{
+    if (numSamples <= 0 || numActive <= 0) return;
+
+    const bool inputSilent = silenceThreshold > 0.0f && peakLevel(channels, numActive, numSamples) < silenceThreshold;
+    if (inputSilent && idle) {
+        if (rampRemaining > 0) setCoefficients(current); // Glides complete while idle
+        for (int c = 0; c < numActive; ++c) std::fill(channels[c], channels[c] + numSamples, Sample(0));
+        return;
+    }
+    idle = false;
+    TeeBeeScopedNoDenormals noDenormals;
+
+    const int factor = oversampler.getFactor();
+    visitBlocks([&](auto& laneBlocks) {
+        if (factor == 1) {
+            processLanes(laneBlocks, channels, numActive, numSamples);
+            return;
+        }
+        for (int offset = 0, n = 0; offset < numSamples; offset += n) {
+            n = std::min(maxBlockSize, numSamples - offset);
+            float* const* oversampled = oversampler.upsample(channels, numActive, offset, n);
+            processLanes(laneBlocks, oversampled, numActive, n * factor);
+            oversampler.downsample(channels, numActive, offset, n);
+        }
+    });
+    if (inputSilent) updateIdle(channels, numActive, numSamples);
+    else quietSamples = 0;
+}
+
+template <class Sample>
+void TeeBeeMultiChannelFilter::updateIdle(Sample* const* channels, int numActive, int numSamples)
+{
+    bool decayed = peakLevel(channels, numActive, numSamples) < silenceThreshold;
+    visitBlocks([&](auto& laneBlocks) {
+        constexpr int numLanes = std::decay_t<decltype(laneBlocks[0])>::numLanes;
+        for (int c = 0; c < numActive && decayed; ++c)
+            decayed = laneBlocks[static_cast<size_t>(c / numLanes)].laneStateMagnitude(c % numLanes) < silenceThreshold;
+    });
+    quietSamples = decayed ? quietSamples + numSamples : 0;
+
+    // The oversampling filters can still hold up to their latency of signal
+    if (quietSamples > oversampler.getLatencySamples()) {
+        reset(); // From rest, so processing resumes exactly as from a fresh start
+        idle = true;
+    }
+}
+
+template <class Block, class Sample>
+void TeeBeeMultiChannelFilter::processLanes(std::vector<Block>& laneBlocks, Sample* const* channels, int numActive, int numSamples)
+{
+    constexpr int numLanes = Block::numLanes;
+    Sample* const laneScratch = [this] {
+        if constexpr (std::is_same_v<Sample, float>) return scratch.data();
+        else return doubleScratch.data();
+    }();
+    Sample* const fadeOutput = [this] {
+        if constexpr (std::is_same_v<Sample, float>) return fadeScratch.data();
+        else return doubleFadeScratch.data();
+    }();
+    std::vector<Block>& fadeLaneBlocks = fadeBlocksFor<Block>();
+    constexpr int fadeChunk = TeeBeeFilter::modeFadeChunk;
+    TeeBeeKernelSetup setup = model.getKernelSetup();
+    setup.scaleToOversampling(oversampler.getFactor());
+    const int maxChunk = static_cast<int>(scratch.size());
+    for (int offset = 0, n = 0; offset < numSamples; offset += n) {
+        n = std::min(maxChunk, numSamples - offset);
+        setup.ramping = rampRemaining > 0;
+        if (setup.ramping) n = std::min(n, rampRemaining);
+        const bool fading = fadeRemaining > 0;
+        if (fading) n = std::min({ n, fadeRemaining, fadeChunk });
+#if TEEBEE_INSTRUMENTATION
+        counters.clipGuards += countInputClips(laneBlocks[0], setup.ramping, channels, numActive, offset, n);
+#endif
+        for (size_t b = 0; b < laneBlocks.size(); ++b) {
+            const int first = static_cast<int>(b) * numLanes;
+            const int activeLanes = std::min(numLanes, numActive - first);
+            if (activeLanes <= 0) break;
+            Sample* laneData[numLanes];
+            for (int lane = 0; lane < numLanes; ++lane)
+                laneData[lane] = lane < activeLanes ? channels[first + lane] + offset : laneScratch;
+
+            // The old mode runs on a copy of the input first
+            Sample* fadeData[numLanes];
+            if (fading) {
+                for (int lane = 0; lane < numLanes; ++lane) {
+                    fadeData[lane] = lane < activeLanes ? fadeOutput + static_cast<size_t>(first + lane) * fadeChunk : laneScratch;
+                    if (lane < activeLanes) std::copy(laneData[lane], laneData[lane] + n, fadeData[lane]);
+                }
+                processLaneBlock(isa, fadeLaneBlocks[b], activeLanes, fadeSetup, fadeData, n);
+            }
+
+            if (activeLanes < numLanes) std::fill(laneScratch, laneScratch + n, Sample(0));
+            processLaneBlock(isa, laneBlocks[b], activeLanes, setup, laneData, n);
+
+            for (int lane = 0; lane < activeLanes; ++lane) {
+                if (!laneBlocks[b].laneIsFinite(lane)) {
+                    laneBlocks[b].resetLane(lane);
+                    std::fill(laneData[lane], laneData[lane] + n, Sample(0));
+#if TEEBEE_INSTRUMENTATION
+                    ++counters.nonFiniteResets;
+#endif
+                }
+                if (!fading) continue;
+                if (!fadeLaneBlocks[b].laneIsFinite(lane)) {
+                    fadeLaneBlocks[b].resetLane(lane);
+                    std::copy(laneData[lane], laneData[lane] + n, fadeData[lane]);
+                }
+                teeBeeCrossfade(fadeData[lane], laneData[lane], n, fadeRemaining, fadeLength);
+            }
+        }
+        if (setup.ramping) rampRemaining -= n;
+        if (fading) fadeRemaining -= n;
+    }
+}
+
+template <class Block, class Sample>
+void TeeBeeMultiChannelFilter::processLaneBlock(Isa isa, Block& block, int activeLanes, const TeeBeeKernelSetup& setup,
+                                                Sample* const* laneData, int numSamples)
+{
+    // A block is one AVX-512 register of lanes; AVX2 covers half of it, SSE2 a quarter
+    constexpr int sse2Lanes = Block::numLanes / 4, avx2Lanes = Block::numLanes / 2;
+#if defined(TEEBEE_HAVE_SSE2_KERNEL)
+    if (isa >= Isa::SSE2 && activeLanes <= sse2Lanes) {
+        teeBeeProcessLaneBlockSSE2(block, activeLanes, setup, laneData, numSamples);
+        return;
+    }
+#endif
+#if defined(TEEBEE_HAVE_AVX2_KERNEL)
+    if (isa >= Isa::AVX2 && (activeLanes <= avx2Lanes || isa == Isa::AVX2)) {
+        teeBeeProcessLaneBlockAVX2(block, activeLanes, setup, laneData, numSamples);
+        return;
+    }
+#endif
+#if defined(TEEBEE_HAVE_AVX512_KERNEL)
+    if (isa >= Isa::AVX512) {
+        teeBeeProcessLaneBlockAVX512(block, activeLanes, setup, laneData, numSamples);
+        return;
+    }
+#endif
+#if defined(TEEBEE_HAVE_SSE2_KERNEL)
+    if (isa >= Isa::SSE2) {
+        teeBeeProcessLaneBlockSSE2(block, activeLanes, setup, laneData, numSamples);
+        return;
+    }
+#endif
+    using ScalarOps = TeeBeeOpsFor<Block, TeeBeeScalarOps, TeeBeeScalarOpsT<float>, TeeBeeScalarMixedOps>;
+    teeBeeProcessLaneBlock<ScalarOps>(block, activeLanes, setup, laneData, numSamples);
+}
+
+static_assert(std::is_same_v<TeeBeeMultiChannelFilter::LaneBlock, TeeBeeDoubleKernelBlock>
+              && std::is_same_v<TeeBeeMultiChannelFilter::MixedLaneBlock, TeeBeeMixedKernelBlock>
+              && std::is_same_v<TeeBeeMultiChannelFilter::FloatLaneBlock, TeeBeeFloatKernelBlock>,
+              "the engine's lane blocks must be the ones the ISA kernels are built for");
+
+#define TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(Block, Sample) \
+    template void TeeBeeMultiChannelFilter::processLaneBlock(Isa, Block&, int, const TeeBeeKernelSetup&, Sample* const*, int);
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::LaneBlock, float)
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::LaneBlock, double)
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::MixedLaneBlock, float)
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::MixedLaneBlock, double)
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::FloatLaneBlock, float)
+TEEBEE_INSTANTIATE_PROCESS_LANE_BLOCK(TeeBeeMultiChannelFilter::FloatLaneBlock, double)
@@ -0,0 +1,179 @@
+#pragma once
+#ifndef TEEBEE_MULTICHANNEL_FILTER_H_INCLUDED
+#define TEEBEE_MULTICHANNEL_FILTER_H_INCLUDED
+
+#include <memory>
+#include <vector>
+#include "TeeBeeAutomation.h"
+#include "TeeBeeFilter.h"
+#include "TeeBeeInstrumentation.h"
+#include "TeeBeeOversampler.h"
+
+/**
+ * TeeBeeMultiChannelFilter (FilterAlphaThree)
+ * - Runs one TeeBee ladder per channel, each channel being a SIMD lane
+ * - Channels are grouped into 8-lane TeeBeeLaneBlocks (structure-of-arrays state)
+ * - The kernel is picked at runtime: SSE2 (2 lanes), AVX2 (4), AVX-512 (8), scalar fallback;
+ *   each block uses the narrowest available kernel that covers its channels, so stereo
+ *   runs as one SSE2 pass and 7.1 as one AVX-512 (or two AVX2) passes
+ * - In double precision, output is bit-identical to running one TeeBeeFilter per channel
+ * - prepare() allocates everything; process() never allocates
+ * - Coefficients come from the process-wide TeeBeeCoefficientTable for the sample rate
+ * - rampParameters() glides every channel by the same per-sample coefficient steps, so all
+ *   channels see identical values at every sample
+ * - Optional 2x/4x/8x oversampling (TeeBeeOversampler) around the ladder; the coefficients and
+ *   the fixed one-pole smoothers are computed for the oversampled rate
+ * - Three precisions (setPrecision): double (the default), mixed
+ *   (float ladder, double feedback path) and float. Float and mixed blocks hold 16 lanes, so the
+ *   same registers carry twice the channels: SSE2 4, AVX2 8, AVX-512 16
+ * - Float or double audio buffers, in every precision
+ * - A mode change while the lanes are running crossfades from the old mode over
+ *   TeeBeeFilter::modeFadeSeconds, like TeeBeeFilter::setMode()
+ * - With TEEBEE_INSTRUMENTATION, counts the samples the ladder's input guard clips (at the
+ *   oversampled rate) and the lanes reset by the non-finite guard (takeCounters)
+ * - Optional silence detection: once the input is silent and the output and every lane's state
+ *   have decayed below the threshold, process() clears the lanes and writes zeros without
+ *   running the ladder until the input comes back
+ * - processAutomated() takes sample-accurate automation points and an audio-rate modulation
+ *   signal (TeeBeeAutomation.h): the block is split at every point, and the coefficients glide
+ *   to the modulated cutoff and resonance every modulationSegment samples on a grid kept across
+ *   blocks, so the output does not depend on the host's block size. Modulated parameters follow
+ *   one segment late (points included); a segment whose values did not change costs one comparison
+ */
+class TeeBeeMultiChannelFilter
+{
+public:
+    enum class Isa { Scalar, SSE2, AVX2, AVX512 };
+    static constexpr int lanesPerBlock = 8; // Double precision; mixed and float blocks hold twice as many
+    static constexpr float defaultSilenceThreshold = 1.0e-5f; // -100 dBFS
+    static constexpr int modulationSegment = 16; // Host-rate samples per modulated coefficient glide
+    using LaneBlock = TeeBeeLaneBlock<lanesPerBlock>;
+    using MixedLaneBlock = TeeBeeMixedLaneBlock<2 * lanesPerBlock>;
+    using FloatLaneBlock = TeeBeeFloatLaneBlock<2 * lanesPerBlock>;
+
+    TeeBeeMultiChannelFilter();
+
+    void prepare(int numChannels, double sampleRate, int maxBlockSize);
+    void reset();
+    void setParameters(const TeeBeeParameters& params);
+    // Glides to `params` over the next numSamples processed samples (see TeeBeeFilter::rampTo);
+    // a ramp still pending is completed at once first
+    void rampParameters(const TeeBeeParameters& params, int numSamples);
+    // The parameters last set, ramped to or reached by an automation point (without modulation)
+    const TeeBeeParameters& getParameters() const { return base; }
+    // factor 1 (off), 2, 4 or 8; never allocates, clears the filter state when anything changes
+    void setOversampling(int factor, TeeBeeOversampler::Phase phase);
+    int getOversamplingFactor() const { return oversampler.getFactor(); }
+    TeeBeeOversampler::Phase getOversamplingPhase() const { return oversampler.getPhase(); }
+    // Latency added by the oversampling filters, in host-rate samples
+    int getLatencySamples() const { return oversampler.getLatencySamples(); }
+    // PRECISION_DOUBLE, PRECISION_MIXED or PRECISION_FLOAT; never allocates, carries the filter
+    // state over (rounded to the new precision) and completes a pending mode crossfade
+    void setPrecision(int newPrecision);
+    int getPrecision() const { return precision; }
+    // Peak level below which input and output count as silent; 0 (the default) disables detection
+    void setSilenceThreshold(float threshold) { silenceThreshold = threshold; }
+    // True while the ladder is skipped because input and filter are silent
+    bool isIdle() const { return idle; }
+    // Processes min(numChannels, prepared channels) buffers in place
+    void process(float* const* channels, int numChannels, int numSamples);
+    void process(double* const* channels, int numChannels, int numSamples);
+    // process() with automation points sorted by offset (TeeBeeAutomation.h) and, unless
+    // `modulation` is nullptr, cutoff and resonance modulated by it (one value per sample) around
+    // the current parameters. A glide still pending from rampParameters() is completed at once
+    // when the block has points
+    void processAutomated(float* const* channels, int numChannels, int numSamples, const TeeBeeParameterEvent* events,
+                          int numEvents, const float* modulation = nullptr, const TeeBeeModulationDepth& depth = {});
+    void processAutomated(double* const* channels, int numChannels, int numSamples, const TeeBeeParameterEvent* events,
+                          int numEvents, const float* modulation = nullptr, const TeeBeeModulationDepth& depth = {});
+
+    int getNumChannels() const { return numChannels; }
+
+    struct Counters
+    {
+        std::uint32_t clipGuards = 0, nonFiniteResets = 0;
+    };
+    // Counts since the last call (always zero without TEEBEE_INSTRUMENTATION)
+    Counters takeCounters()
+    {
+        const Counters taken = counters;
+        counters = {};
+        return taken;
+    }
+
+    // Highest instruction set the CPU (and this build) supports
+    static Isa detectIsa();
+    static const char* getIsaName(Isa isa);
+    // Caps the kernels used to `maxIsa` (for benchmarks and tests); returns the effective ISA
+    Isa setMaxIsa(Isa maxIsa);
+    Isa getIsa() const { return isa; }
+    // Runs one lane block (LaneBlock, MixedLaneBlock or FloatLaneBlock) with the narrowest
+    // kernel (up to `isa`) that covers activeLanes
+    template <class Block, class Sample>
+    static void processLaneBlock(Isa isa, Block& block, int activeLanes, const TeeBeeKernelSetup& setup,
+                                 Sample* const* channels, int numSamples);
+
+private:
+    template <class Sample> void processAny(Sample* const* channels, int numActive, int numSamples);
+    template <class Sample>
+    void processAutomatedAny(Sample* const* channels, int numActive, int numSamples, const TeeBeeParameterEvent* events,
+                             int numEvents, const float* modulation, const TeeBeeModulationDepth& depth);
+    // Samples [offset, offset + numSamples) of the block, without or with modulation
+    template <class Sample> void processUnmodulated(Sample* const* channels, int numActive, int offset, int numSamples);
+    template <class Sample>
+    void processModulated(Sample* const* channels, int numActive, int offset, int numSamples, const float* modulation,
+                          const TeeBeeModulationDepth& depth);
+    // The channel pointers advanced by offset samples (into a buffer allocated by prepare())
+    template <class Sample> Sample* const* channelsAt(Sample* const* channels, int numActive, int offset);
+    // Coefficients only: setParameters() and rampParameters() also move the unmodulated parameters
+    void setCoefficients(const TeeBeeParameters& params);
+    void rampCoefficients(const TeeBeeParameters& params, int numSamples);
+    // The unmodulated parameters `elapsed` host-rate samples into their glide
+    TeeBeeParameters baseAt(int elapsed) const;
+    // Runs numSamples at the filter's (possibly oversampled) rate through every active block
+    template <class Block, class Sample>
+    void processLanes(std::vector<Block>& laneBlocks, Sample* const* channels, int numActive, int numSamples);
+    // After a block with silent input: goes idle once the output and state stay below the threshold
+    template <class Sample> void updateIdle(Sample* const* channels, int numActive, int numSamples);
+    // Calls f with the lane blocks of the current precision
+    template <class F> void visitBlocks(F&& f);
+    // Copies the lanes and the kernel setup of the current mode, to be faded out
+    void startModeFade();
+    template <class Block> std::vector<Block>& fadeBlocksFor();
+
+    TeeBeeFilter model; // Computes coefficients from parameters
+    std::shared_ptr<const TeeBeeCoefficientTable> coefficientTables[TeeBeeOversampler::maxStages + 1]; // Per factor
+    TeeBeeParameters current; // What the coefficients were computed from (modulated or not)
+    TeeBeeParameters base, baseFrom; // Unmodulated: glides from baseFrom to base over baseRampLength
+    int baseRampLength = 0, baseRampDone = 0; // At the host rate
+    int modulationPhase = 0; // Host-rate samples into the current modulation segment
+    float lastModulation = 0.0f; // The modulation's last sample, the next segment's target
+    TeeBeeModulationDepth modulationDepth;
+    bool modulated = false; // The coefficients follow the modulation rather than `base`
+    std::vector<float*> floatChannelsAt; // channelsAt() pointers
+    std::vector<double*> doubleChannelsAt;
+    int rampRemaining = 0; // At the oversampled rate
+    std::vector<LaneBlock> blocks;
+    std::vector<MixedLaneBlock> mixedBlocks;
+    std::vector<FloatLaneBlock> floatBlocks;
+    std::vector<LaneBlock> fadeBlocks; // Old mode during a crossfade, same layout as the blocks
+    std::vector<MixedLaneBlock> mixedFadeBlocks;
+    std::vector<FloatLaneBlock> floatFadeBlocks;
+    TeeBeeKernelSetup fadeSetup;
+    int fadeRemaining = 0, fadeLength = 1; // At the oversampled rate
+    std::vector<float> fadeScratch; // Old mode's output, modeFadeChunk samples per channel
+    std::vector<double> doubleFadeScratch;
+    int precision = PRECISION_DOUBLE;
+    std::vector<float> scratch; // Input/output of unused lanes
+    std::vector<double> doubleScratch;
+    TeeBeeOversampler oversampler;
+    double hostSampleRate = 44100.0;
+    float silenceThreshold = 0.0f;
+    int quietSamples = 0; // Host-rate samples of silent input with decayed output and state
+    bool idle = false;
+    Counters counters;
+    int numChannels = 0, maxBlockSize = 0;
+    Isa isa = Isa::Scalar;
+};
+
+#endif // TEEBEE_MULTICHANNEL_FILTER_H_INCLUDED
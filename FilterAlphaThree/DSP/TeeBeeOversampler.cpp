@@ -0,0 +1,329 @@
+#include "TeeBeeOversampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+
+namespace
+{
+constexpr double pi = 3.14159265358979323846;
+constexpr double stopbandDb = 90.0;
+constexpr double kaiserMarginDb = 3.0; // Extra attenuation the FIR window is designed for (designFir)
+constexpr double passbandFraction = 0.9; // Of the host Nyquist frequency
+
+// Passband edge of stage `stage` as a fraction of that stage's input Nyquist frequency. Later
+// stages must also pass the first stage's transition band (up to 2 - 0.9 host Nyquist), or its
+// images land in their own transition bands.
+double stagePassband(int stage)
+{
+    return (stage == 0 ? passbandFraction : 2.0 - passbandFraction) / static_cast<double>(1 << stage);
+}
+
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; term > 1e-12 * sum; ++k) {
+        term *= (x * 0.5 / k) * (x * 0.5 / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Elliptic half-band prototype (Valenzuela & Constantinides), as popularised by HIIR
+void transitionParameters(double transition, double& k, double& q)
+{
+    k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+    k *= k;
+    const double kksqrt = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    const double e4 = e * e * e * e;
+    q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+}
+
+double accumulateNumerator(double q, int order, int c)
+{
+    double acc = 0.0, term = 0.0;
+    int sign = 1;
+    for (int i = 0; i == 0 || std::abs(term) > 1e-100; ++i, sign = -sign) {
+        term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * pi / order) * sign;
+        acc += term;
+    }
+    return acc;
+}
+
+double accumulateDenominator(double q, int order, int c)
+{
+    double acc = 0.0, term = 0.0;
+    int sign = -1;
+    for (int i = 1; i == 1 || std::abs(term) > 1e-100; ++i, sign = -sign) {
+        term = std::pow(q, i * i) * std::cos(i * 2 * c * pi / order) * sign;
+        acc += term;
+    }
+    return acc;
+}
+} // namespace
+
+// Designs
+TeeBeeOversampler::FirDesign TeeBeeOversampler::designFir(int stage)
+{
+    // Kaiser's estimates fall a dB or two short of stopbandDb: window for kaiserMarginDb more (the
+    // margin that gives the shortest filters), then lengthen the filter until its response meets stopbandDb
+    const double transition = pi * (1.0 - stagePassband(stage));
+    const double beta = 0.1102 * (stopbandDb + kaiserMarginDb - 8.7);
+    const int minTaps = static_cast<int>(std::ceil((stopbandDb - 8.0) / (2.285 * transition)));
+    const double stopbandEdge = pi - 0.5 * (pi - transition), maxStopbandGain = std::pow(10.0, -stopbandDb / 20.0);
+
+    FirDesign design;
+    for (design.m = std::max(0, minTaps / 4);; ++design.m) { // From the smallest 4m + 3 >= minTaps
+        const int numTaps = 4 * design.m + 3, centre = 2 * design.m + 1;
+        design.taps.clear();
+        double sum = 0.0;
+        for (int l = 0; l <= 2 * design.m + 1; ++l) {
+            const int k = 2 * l;
+            const double x = (k - centre) * 0.5, r = 2.0 * k / (numTaps - 1) - 1.0;
+            const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+            design.taps.push_back(0.5 * std::sin(pi * x) / (pi * x) * window);
+            sum += design.taps.back();
+        }
+        for (auto& tap : design.taps) tap *= 0.5 / sum; // Even branch carries half the DC gain
+
+        // Largest gain from the stopband edge to Nyquist at the output rate, 16 points per tap
+        double stopbandGain = 0.0;
+        const int numPoints = 16 * numTaps;
+        for (int i = 0; i <= numPoints; ++i) {
+            const double w = stopbandEdge + (pi - stopbandEdge) * i / numPoints;
+            std::complex<double> h = std::polar(0.5, -w * centre);
+            for (size_t l = 0; l < design.taps.size(); ++l)
+                h += design.taps[l] * std::polar(1.0, -w * 2.0 * static_cast<double>(l));
+            stopbandGain = std::max(stopbandGain, std::abs(h));
+        }
+        if (stopbandGain <= maxStopbandGain) return design;
+    }
+}
+
+TeeBeeOversampler::IirDesign TeeBeeOversampler::designIir(int stage)
+{
+    // Transition band from the passband edge up to its mirror image, relative to the output rate
+    const double transition = 0.5 * (1.0 - stagePassband(stage));
+    double k = 0.0, q = 0.0;
+    transitionParameters(transition, k, q);
+    const double attenuation = std::pow(10.0, -stopbandDb / 10.0);
+    const double a = attenuation / (1.0 - attenuation);
+    int order = static_cast<int>(std::ceil(std::log(a * a / 16.0) / std::log(q)));
+    if ((order & 1) == 0) ++order;
+    if (order == 1) order = 3;
+
+    IirDesign design;
+    for (int index = 0; index < (order - 1) / 2; ++index) {
+        const double ww = accumulateNumerator(q, order, index + 1) * std::pow(q, 0.25)
+                        / (accumulateDenominator(q, order, index + 1) + 0.5);
+        const double wwsq = ww * ww;
+        const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        design.coefs.push_back((1.0 - x) / (1.0 + x));
+    }
+    return design;
+}
+
+// Setup
+void TeeBeeOversampler::prepare(int numChannels, int newMaxBlockSize)
+{
+    maxBlockSize = std::max(1, newMaxBlockSize);
+    for (int s = 0; s < maxStages; ++s) {
+        fir[s] = designFir(s);
+        iir[s] = designIir(s);
+    }
+
+    channelStates.assign(static_cast<size_t>(std::max(0, numChannels)), ChannelState{});
+    for (auto& ch : channelStates) {
+        for (int s = 0; s < maxStages; ++s) {
+            const size_t numIn = static_cast<size_t>(maxBlockSize) << s; // Stage input length
+            const size_t taps = fir[s].taps.size();
+            auto& st = ch.stages[s];
+            st.upHistory.assign(taps - 1 + numIn, 0.0);
+            st.downEven.assign(taps - 1 + numIn, 0.0);
+            st.downOdd.assign(static_cast<size_t>(fir[s].m) + 1 + numIn, 0.0);
+            st.upX.assign(iir[s].coefs.size(), 0.0);
+            st.upY = st.downX = st.downY = st.upX;
+        }
+        ch.bufferA.assign(static_cast<size_t>(maxBlockSize) * maxFactor, 0.0f);
+        ch.bufferB = ch.bufferA;
+        ch.delay.assign(maxFactor, 0.0f);
+    }
+    upPointers.assign(channelStates.size(), nullptr);
+    setup(getFactor(), phase);
+}
+
+void TeeBeeOversampler::setup(int factor, Phase newPhase)
+{
+    numStages = 0;
+    while (numStages < maxStages && (1 << numStages) < factor) ++numStages;
+    phase = newPhase;
+
+    if (phase == Phase::Linear) {
+        // Stage latencies are fractional at the host rate: pad at the oversampled rate to a whole sample
+        const int factorOut = 1 << numStages;
+        int total = 0; // In oversampled samples
+        for (int s = 0; s < numStages; ++s) total += (2 * fir[s].m + 1) * (factorOut >> s);
+        delaySamples = (factorOut - total % factorOut) % factorOut;
+        latency = (total + delaySamples) / factorOut;
+    }
+    else {
+        // Group delay at DC: each allpass section a adds 2(1 - a)/(1 + a) oversampled samples
+        double total = 0.0; // In host samples
+        for (int s = 0; s < numStages; ++s) {
+            // The up and down paths' one-sample polyphase offsets cancel
+            double stageDelay = 0.0;
+            for (double a : iir[s].coefs) stageDelay += 2.0 * (1.0 - a) / (1.0 + a);
+            total += stageDelay / static_cast<double>(2 << s); // Up + down, (2 << s)x rate
+        }
+        delaySamples = 0;
+        latency = static_cast<int>(std::lround(total));
+    }
+    reset();
+}
+
+void TeeBeeOversampler::reset()
+{
+    for (auto& ch : channelStates) {
+        for (auto& st : ch.stages) {
+            for (auto* v : { &st.upHistory, &st.downEven, &st.downOdd, &st.upX, &st.upY, &st.downX, &st.downY })
+                std::fill(v->begin(), v->end(), 0.0);
+        }
+        std::fill(ch.delay.begin(), ch.delay.end(), 0.0f);
+        ch.delayPos = 0;
+    }
+}
+
+// Processing
+template <class Sample>
+float* const* TeeBeeOversampler::upsample(const Sample* const* channels, int numChannels, int offset, int numSamples)
+{
+    const int n = std::min(numChannels, static_cast<int>(channelStates.size()));
+    for (int c = 0; c < n; ++c) {
+        auto& ch = channelStates[static_cast<size_t>(c)];
+        const Sample* in = channels[c] + offset;
+        float* out = ch.bufferA.data();
+        if (numStages == 0) {
+            // Nothing to filter: hand back the input itself, or a float copy of it
+            if constexpr (std::is_same_v<Sample, float>) out = const_cast<float*>(in);
+            else for (int i = 0; i < numSamples; ++i) out[i] = static_cast<float>(in[i]);
+        }
+        else {
+            upStage(0, ch, in, out, numSamples);
+            for (int s = 1; s < numStages; ++s) {
+                float* next = out == ch.bufferA.data() ? ch.bufferB.data() : ch.bufferA.data();
+                upStage(s, ch, out, next, numSamples << s);
+                out = next;
+            }
+        }
+        upPointers[static_cast<size_t>(c)] = out;
+    }
+    return upPointers.data();
+}
+
+template <class Sample>
+void TeeBeeOversampler::downsample(Sample* const* channels, int numChannels, int offset, int numSamples)
+{
+    const int n = std::min(numChannels, static_cast<int>(channelStates.size()));
+    const int numOversampled = numSamples << numStages;
+    for (int c = 0; c < n; ++c) {
+        auto& ch = channelStates[static_cast<size_t>(c)];
+        float* in = upPointers[static_cast<size_t>(c)];
+        if (delaySamples > 0) {
+            for (int i = 0; i < numOversampled; ++i) {
+                std::swap(in[i], ch.delay[static_cast<size_t>(ch.delayPos)]);
+                if (++ch.delayPos == delaySamples) ch.delayPos = 0;
+            }
+        }
+        float* other = in == ch.bufferA.data() ? ch.bufferB.data() : ch.bufferA.data();
+        for (int s = numStages - 1; s > 0; --s) {
+            downStage(s, ch, in, other, numSamples << s);
+            std::swap(in, other);
+        }
+        Sample* out = channels[c] + offset;
+        if (numStages > 0) downStage(0, ch, in, out, numSamples);
+        else if constexpr (!std::is_same_v<Sample, float>)
+            for (int i = 0; i < numSamples; ++i) out[i] = in[i];
+    }
+}
+
+template <class In>
+void TeeBeeOversampler::upStage(int stage, ChannelState& ch, const In* in, float* out, int numIn) const
+{
+    auto& st = ch.stages[stage];
+    if (phase == Phase::Linear) {
+        const auto& g = fir[stage].taps;
+        const int taps = static_cast<int>(g.size()), m = fir[stage].m;
+        double* h = st.upHistory.data();
+        for (int j = 0; j < numIn; ++j) h[taps - 1 + j] = in[j];
+        for (int j = 0; j < numIn; ++j) {
+            const double* x = h + taps - 1 + j; // x[-l] is the input l samples back
+            double acc = 0.0;
+            for (int l = 0; l < taps; ++l) acc += g[static_cast<size_t>(l)] * x[-l];
+            out[2 * j] = static_cast<float>(2.0 * acc);
+            out[2 * j + 1] = static_cast<float>(x[-m]);
+        }
+        std::copy(h + numIn, h + numIn + taps - 1, h);
+        return;
+    }
+
+    const auto& coefs = iir[stage].coefs;
+    const int numCoefs = static_cast<int>(coefs.size());
+    for (int j = 0; j < numIn; ++j) {
+        double even = in[j], odd = in[j];
+        for (int i = 0; i < numCoefs; ++i) {
+            double& v = (i & 1) == 0 ? even : odd;
+            const double y = (v - st.upY[static_cast<size_t>(i)]) * coefs[static_cast<size_t>(i)] + st.upX[static_cast<size_t>(i)];
+            st.upX[static_cast<size_t>(i)] = v;
+            st.upY[static_cast<size_t>(i)] = y;
+            v = y;
+        }
+        out[2 * j] = static_cast<float>(even);
+        out[2 * j + 1] = static_cast<float>(odd);
+    }
+}
+
+template <class Out>
+void TeeBeeOversampler::downStage(int stage, ChannelState& ch, const float* in, Out* out, int numOut) const
+{
+    auto& st = ch.stages[stage];
+    if (phase == Phase::Linear) {
+        const auto& g = fir[stage].taps;
+        const int taps = static_cast<int>(g.size()), m = fir[stage].m;
+        double* even = st.downEven.data();
+        double* odd = st.downOdd.data();
+        for (int j = 0; j < numOut; ++j) {
+            even[taps - 1 + j] = in[2 * j];
+            odd[m + 1 + j] = in[2 * j + 1];
+        }
+        for (int j = 0; j < numOut; ++j) {
+            const double* x = even + taps - 1 + j;
+            double acc = 0.5 * odd[j]; // Centre tap, 2m + 1 input samples back
+            for (int l = 0; l < taps; ++l) acc += g[static_cast<size_t>(l)] * x[-l];
+            out[j] = static_cast<Out>(acc);
+        }
+        std::copy(even + numOut, even + numOut + taps - 1, even);
+        std::copy(odd + numOut, odd + numOut + m + 1, odd);
+        return;
+    }
+
+    const auto& coefs = iir[stage].coefs;
+    const int numCoefs = static_cast<int>(coefs.size());
+    for (int j = 0; j < numOut; ++j) {
+        double a = in[2 * j + 1], b = in[2 * j];
+        for (int i = 0; i < numCoefs; ++i) {
+            double& v = (i & 1) == 0 ? a : b;
+            const double y = (v - st.downY[static_cast<size_t>(i)]) * coefs[static_cast<size_t>(i)] + st.downX[static_cast<size_t>(i)];
+            st.downX[static_cast<size_t>(i)] = v;
+            st.downY[static_cast<size_t>(i)] = y;
+            v = y;
+        }
+        out[j] = static_cast<Out>(0.5 * (a + b));
+    }
+}
+
+template float* const* TeeBeeOversampler::upsample(const float* const*, int, int, int);
+template float* const* TeeBeeOversampler::upsample(const double* const*, int, int, int);
+template void TeeBeeOversampler::downsample(float* const*, int, int, int);
+template void TeeBeeOversampler::downsample(double* const*, int, int, int);
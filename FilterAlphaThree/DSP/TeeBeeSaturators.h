@@ -0,0 +1,103 @@
+#pragma once
+#ifndef TEEBEE_SATURATORS_H_INCLUDED
+#define TEEBEE_SATURATORS_H_INCLUDED
+
+#include <cmath>
+
+/**
+ * tanh saturators for the TeeBee ladder (FilterAlphaThree)
+ * - The kernel calls Sat::apply<Ops>(x) with x already clamped to [-6, 6]
+ * - Every tier is written against the kernel's lane type, so the SIMD kernels run it
+ *   on whole registers (or lane by lane where the ISA has no better option)
+ * - Compile-time choice: teeBeeProcessLanes<Ops, Sat, ...> / TeeBeeFilter::processBlockWith<Sat>;
+ *   runtime choice: TeeBeeQuality through TeeBeeFilter::setQuality or TeeBeeParameters::quality
+ *
+ * Tier       max |error| on [-6, 6]   notes
+ * EXACT      0 (reference)            libm std::tanh, lane by lane
+ * TABLE      5.2e-8  (-146 dB)        256-interval cubic Hermite table, 2 KB, built at compile time
+ * PADE       4.2e-6  (-108 dB)        [9/8] Pade approximant, one divide, fully vectorized
+ */
+
+enum TeeBeeQuality { QUALITY_EXACT, QUALITY_TABLE, QUALITY_PADE, NUM_QUALITIES };
+
+struct TeeBeeTanhExact
+{
+    static constexpr double maxError = 0.0;
+
+    template <class Ops>
+    static typename Ops::V apply(typename Ops::V x) { return Ops::tanh(x); }
+};
+
+struct TeeBeeTanhPade
+{
+    static constexpr double maxError = 4.2e-6;
+
+    template <class Ops>
+    static typename Ops::V apply(typename Ops::V x)
+    {
+        using V = typename Ops::V;
+        const V x2 = x * x;
+        const V num = x * (V(34459425.0) + x2 * (V(4729725.0) + x2 * (V(135135.0) + x2 * (V(990.0) + x2))));
+        const V den = V(34459425.0) + x2 * (V(16216200.0) + x2 * (V(945945.0) + x2 * (V(13860.0) + x2 * V(45.0))));
+        return Ops::clip(num / den, V(-1.0), V(1.0));
+    }
+};
+
+// tanh without libm, for building tables at compile time (absolute error < 1e-12)
+constexpr double teeBeeConstexprTanh(double x)
+{
+    const double ax = x < 0.0 ? -x : x;
+    double r = 2.0 * ax;
+    int halvings = 0;
+    while (r > 1.0 / 1024.0) { r *= 0.5; ++halvings; }
+    double term = 1.0, e = 1.0;
+    for (int n = 1; n < 12; ++n) { term *= r / n; e += term; }
+    while (halvings-- > 0) e *= e;
+    const double t = 1.0 - 2.0 / (e + 1.0);
+    return x < 0.0 ? -t : t;
+}
+
+// tanh at `Size + 1` evenly spaced points over [-range, range]
+template <int Size>
+struct TeeBeeTanhTableData
+{
+    double value[Size + 1] = {};
+
+    constexpr explicit TeeBeeTanhTableData(double range)
+    {
+        for (int i = 0; i <= Size; ++i) value[i] = teeBeeConstexprTanh(-range + i * (2.0 * range / Size));
+    }
+};
+
+struct TeeBeeTanhTable
+{
+    static constexpr double maxError = 5.2e-8;
+    static constexpr int size = 256;
+    static constexpr double range = 6.0;
+    static constexpr double step = 2.0 * range / size;
+    // Computed by the compiler, so every ISA translation unit shares identical constant data
+    static constexpr TeeBeeTanhTableData<size> data { range };
+
+    // Cubic Hermite through the two neighbouring entries, slopes from tanh' = 1 - tanh^2.
+    // Evaluated in the lane's scalar type (Ops::T), so the float kernels stay in float
+    template <class Ops>
+    static typename Ops::V apply(typename Ops::V x)
+    {
+        using T = typename Ops::T;
+        alignas(64) T lanes[Ops::width];
+        Ops::store(lanes, x);
+        for (int l = 0; l < Ops::width; ++l) {
+            const T u = (lanes[l] + T(range)) * T(1.0 / step);
+            int i = static_cast<int>(u);
+            i = i < 0 ? 0 : (i > size - 1 ? size - 1 : i);
+            const T t = u - T(i), t2 = t * t, t3 = t2 * t;
+            const T y0 = T(data.value[i]), y1 = T(data.value[i + 1]);
+            const T d0 = (T(1) - y0 * y0) * T(step), d1 = (T(1) - y1 * y1) * T(step);
+            lanes[l] = (T(2) * t3 - T(3) * t2 + T(1)) * y0 + (t3 - T(2) * t2 + t) * d0
+                     + (T(3) * t2 - T(2) * t3) * y1 + (t3 - t2) * d1;
+        }
+        return Ops::load(lanes);
+    }
+};
+
+#endif // TEEBEE_SATURATORS_H_INCLUDED
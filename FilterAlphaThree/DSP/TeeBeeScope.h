@@ -0,0 +1,92 @@
+#pragma once
+#ifndef TEEBEE_SCOPE_H_INCLUDED
+#define TEEBEE_SCOPE_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Output scope plumbing (FilterAlphaThree editor display)
+ * - The audio thread copies whole blocks into a lock-free single-producer/single-consumer
+ *   TeeBeeSampleFifo; whatever does not fit is dropped, it never blocks or allocates
+ * - The display thread drains the FIFO into a TeeBeeScopeBuffer, which keeps the latest samples
+ *   and hands out a window starting at a rising zero crossing, so periodic signals stand still
+ */
+
+template <std::size_t Capacity>
+class TeeBeeSampleFifo
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Writer: copies as much of the block as fits; returns the number of samples written
+    template <class Sample>
+    int push(const Sample* data, int numSamples) noexcept
+    {
+        const std::uint32_t h = head.load(std::memory_order_relaxed);
+        const std::uint32_t space = static_cast<std::uint32_t>(Capacity) - (h - tail.load(std::memory_order_acquire));
+        const int n = static_cast<int>(std::min<std::uint32_t>(space, static_cast<std::uint32_t>(std::max(numSamples, 0))));
+        for (int i = 0; i < n; ++i) samples[(h + static_cast<std::uint32_t>(i)) & (Capacity - 1)] = static_cast<float>(data[i]);
+        head.store(h + static_cast<std::uint32_t>(n), std::memory_order_release);
+        return n;
+    }
+
+    // Reader: up to maxSamples; returns the number read
+    int pop(float* out, int maxSamples) noexcept
+    {
+        const std::uint32_t t = tail.load(std::memory_order_relaxed);
+        const std::uint32_t available = head.load(std::memory_order_acquire) - t;
+        const int n = static_cast<int>(std::min<std::uint32_t>(available, static_cast<std::uint32_t>(std::max(maxSamples, 0))));
+        for (int i = 0; i < n; ++i) out[i] = samples[(t + static_cast<std::uint32_t>(i)) & (Capacity - 1)];
+        tail.store(t + static_cast<std::uint32_t>(n), std::memory_order_release);
+        return n;
+    }
+
+private:
+    std::array<float, Capacity> samples {};
+    alignas(64) std::atomic<std::uint32_t> head { 0 };
+    alignas(64) std::atomic<std::uint32_t> tail { 0 };
+};
+
+class TeeBeeScopeBuffer
+{
+public:
+    explicit TeeBeeScopeBuffer(int historySize = 16384) : history(static_cast<std::size_t>(std::max(historySize, 2)), 0.0f) {}
+
+    int getHistorySize() const { return static_cast<int>(history.size()); }
+
+    void write(const float* data, int numSamples)
+    {
+        const auto size = history.size();
+        const auto n = std::min(size, static_cast<std::size_t>(std::max(numSamples, 0)));
+        std::copy(history.begin() + static_cast<std::ptrdiff_t>(n), history.end(), history.begin());
+        std::copy(data + (numSamples - static_cast<int>(n)), data + numSamples, history.end() - static_cast<std::ptrdiff_t>(n));
+    }
+
+    // The `length` samples (at most half the history) after the latest rising zero crossing that
+    // still has `length` samples behind it, or simply the latest `length` samples if there is none
+    void read(float* out, int length) const
+    {
+        const int size = getHistorySize();
+        length = std::clamp(length, 1, size / 2);
+        int start = size - length;
+        for (int i = size - length; i > size - 2 * length; --i) {
+            if (history[static_cast<std::size_t>(i - 1)] < 0.0f && history[static_cast<std::size_t>(i)] >= 0.0f) {
+                start = i;
+                break;
+            }
+        }
+        std::copy_n(history.begin() + start, length, out);
+    }
+
+    void clear() { std::fill(history.begin(), history.end(), 0.0f); }
+
+private:
+    std::vector<float> history; // Oldest first
+};
+
+#endif // TEEBEE_SCOPE_H_INCLUDED
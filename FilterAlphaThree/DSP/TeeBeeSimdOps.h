@@ -0,0 +1,395 @@
+#pragma once
+#ifndef TEEBEE_SIMD_OPS_H_INCLUDED
+#define TEEBEE_SIMD_OPS_H_INCLUDED
+
+#include <cmath>
+#include "TeeBeeKernel.h"
+
+/**
+ * SIMD lane types for teeBeeProcessLanes (FilterAlphaThree)
+ * - Each type wraps one register of doubles or floats and provides the operators the kernel uses
+ * - Only the types enabled by the current translation unit's target flags are defined;
+ *   TeeBeeKernelSSE2/AVX2/AVX512.cpp are compiled with the matching flags and selected
+ *   at runtime by TeeBeeMultiChannelFilter
+ * - clip() is min(hi, max(lo, v)) so NaN propagates exactly like the scalar clip and
+ *   the non-finite guard still sees it
+ * - The float types carry twice the lanes of the double ones. Their mixed-precision variants
+ *   run the feedback path on a pair of double registers (TeeBeePairOps) covering the same lanes
+ */
+
+// Two registers used as one lane type of twice the width
+template <class Ops>
+struct TeeBeePairOps
+{
+    struct V
+    {
+        typename Ops::V lo, hi;
+        V() = default;
+        V(typename Ops::V l, typename Ops::V h) : lo(l), hi(h) {}
+        explicit V(double x) : lo(x), hi(x) {}
+        friend V operator+(V a, V b) { return { a.lo + b.lo, a.hi + b.hi }; }
+        friend V operator-(V a, V b) { return { a.lo - b.lo, a.hi - b.hi }; }
+        friend V operator*(V a, V b) { return { a.lo * b.lo, a.hi * b.hi }; }
+        friend V operator/(V a, V b) { return { a.lo / b.lo, a.hi / b.hi }; }
+    };
+    using T = typename Ops::T;
+    using WideOps = TeeBeePairOps;
+    static constexpr int width = 2 * Ops::width;
+
+    static V load(const T* p) { return { Ops::load(p), Ops::load(p + Ops::width) }; }
+    static void store(T* p, V x) { Ops::store(p, x.lo); Ops::store(p + Ops::width, x.hi); }
+    static V clip(V x, V lo, V hi) { return { Ops::clip(x.lo, lo.lo, hi.lo), Ops::clip(x.hi, lo.hi, hi.hi) }; }
+};
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+struct TeeBeeVecSSE2
+{
+    __m128d v;
+    TeeBeeVecSSE2() = default;
+    TeeBeeVecSSE2(__m128d x) : v(x) {}
+    explicit TeeBeeVecSSE2(double x) : v(_mm_set1_pd(x)) {}
+    friend TeeBeeVecSSE2 operator+(TeeBeeVecSSE2 a, TeeBeeVecSSE2 b) { return _mm_add_pd(a.v, b.v); }
+    friend TeeBeeVecSSE2 operator-(TeeBeeVecSSE2 a, TeeBeeVecSSE2 b) { return _mm_sub_pd(a.v, b.v); }
+    friend TeeBeeVecSSE2 operator*(TeeBeeVecSSE2 a, TeeBeeVecSSE2 b) { return _mm_mul_pd(a.v, b.v); }
+    friend TeeBeeVecSSE2 operator/(TeeBeeVecSSE2 a, TeeBeeVecSSE2 b) { return _mm_div_pd(a.v, b.v); }
+};
+
+struct TeeBeeSse2Ops
+{
+    using V = TeeBeeVecSSE2;
+    using T = double;
+    using WideOps = TeeBeeSse2Ops;
+    static constexpr int width = 2;
+
+    static V load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, V x) { _mm_storeu_pd(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i) { return _mm_set_pd(ch[1][i], ch[0][i]); }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(16) double t[width];
+        _mm_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    static V clip(V x, V lo, V hi) { return _mm_min_pd(hi.v, _mm_max_pd(lo.v, x.v)); }
+    static V tanh(V x)
+    {
+        alignas(16) double t[width];
+        _mm_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm_load_pd(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeVecSSE2F
+{
+    __m128 v;
+    TeeBeeVecSSE2F() = default;
+    TeeBeeVecSSE2F(__m128 x) : v(x) {}
+    explicit TeeBeeVecSSE2F(double x) : v(_mm_set1_ps(static_cast<float>(x))) {}
+    friend TeeBeeVecSSE2F operator+(TeeBeeVecSSE2F a, TeeBeeVecSSE2F b) { return _mm_add_ps(a.v, b.v); }
+    friend TeeBeeVecSSE2F operator-(TeeBeeVecSSE2F a, TeeBeeVecSSE2F b) { return _mm_sub_ps(a.v, b.v); }
+    friend TeeBeeVecSSE2F operator*(TeeBeeVecSSE2F a, TeeBeeVecSSE2F b) { return _mm_mul_ps(a.v, b.v); }
+    friend TeeBeeVecSSE2F operator/(TeeBeeVecSSE2F a, TeeBeeVecSSE2F b) { return _mm_div_ps(a.v, b.v); }
+};
+
+struct TeeBeeSse2FloatOps
+{
+    using V = TeeBeeVecSSE2F;
+    using T = float;
+    using WideOps = TeeBeeSse2FloatOps;
+    static constexpr int width = 4;
+
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V x) { _mm_storeu_ps(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i)
+    {
+        return _mm_set_ps(static_cast<float>(ch[3][i]), static_cast<float>(ch[2][i]),
+                          static_cast<float>(ch[1][i]), static_cast<float>(ch[0][i]));
+    }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(16) float t[width];
+        _mm_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    static V clip(V x, V lo, V hi) { return _mm_min_ps(hi.v, _mm_max_ps(lo.v, x.v)); }
+    static V tanh(V x)
+    {
+        alignas(16) float t[width];
+        _mm_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm_load_ps(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeSse2MixedOps : TeeBeeSse2FloatOps
+{
+    using WideOps = TeeBeePairOps<TeeBeeSse2Ops>;
+    static WideOps::V widen(V x) { return { _mm_cvtps_pd(x.v), _mm_cvtps_pd(_mm_movehl_ps(x.v, x.v)) }; }
+    static V narrow(WideOps::V x) { return _mm_movelh_ps(_mm_cvtpd_ps(x.lo.v), _mm_cvtpd_ps(x.hi.v)); }
+};
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+struct TeeBeeVecAVX2
+{
+    __m256d v;
+    TeeBeeVecAVX2() = default;
+    TeeBeeVecAVX2(__m256d x) : v(x) {}
+    explicit TeeBeeVecAVX2(double x) : v(_mm256_set1_pd(x)) {}
+    friend TeeBeeVecAVX2 operator+(TeeBeeVecAVX2 a, TeeBeeVecAVX2 b) { return _mm256_add_pd(a.v, b.v); }
+    friend TeeBeeVecAVX2 operator-(TeeBeeVecAVX2 a, TeeBeeVecAVX2 b) { return _mm256_sub_pd(a.v, b.v); }
+    friend TeeBeeVecAVX2 operator*(TeeBeeVecAVX2 a, TeeBeeVecAVX2 b) { return _mm256_mul_pd(a.v, b.v); }
+    friend TeeBeeVecAVX2 operator/(TeeBeeVecAVX2 a, TeeBeeVecAVX2 b) { return _mm256_div_pd(a.v, b.v); }
+};
+
+struct TeeBeeAvx2Ops
+{
+    using V = TeeBeeVecAVX2;
+    using T = double;
+    using WideOps = TeeBeeAvx2Ops;
+    static constexpr int width = 4;
+
+    static V load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, V x) { _mm256_storeu_pd(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i) { return _mm256_set_pd(ch[3][i], ch[2][i], ch[1][i], ch[0][i]); }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(32) double t[width];
+        _mm256_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    static V clip(V x, V lo, V hi) { return _mm256_min_pd(hi.v, _mm256_max_pd(lo.v, x.v)); }
+    static V tanh(V x)
+    {
+        alignas(32) double t[width];
+        _mm256_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm256_load_pd(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeVecAVX2F
+{
+    __m256 v;
+    TeeBeeVecAVX2F() = default;
+    TeeBeeVecAVX2F(__m256 x) : v(x) {}
+    explicit TeeBeeVecAVX2F(double x) : v(_mm256_set1_ps(static_cast<float>(x))) {}
+    friend TeeBeeVecAVX2F operator+(TeeBeeVecAVX2F a, TeeBeeVecAVX2F b) { return _mm256_add_ps(a.v, b.v); }
+    friend TeeBeeVecAVX2F operator-(TeeBeeVecAVX2F a, TeeBeeVecAVX2F b) { return _mm256_sub_ps(a.v, b.v); }
+    friend TeeBeeVecAVX2F operator*(TeeBeeVecAVX2F a, TeeBeeVecAVX2F b) { return _mm256_mul_ps(a.v, b.v); }
+    friend TeeBeeVecAVX2F operator/(TeeBeeVecAVX2F a, TeeBeeVecAVX2F b) { return _mm256_div_ps(a.v, b.v); }
+};
+
+struct TeeBeeAvx2FloatOps
+{
+    using V = TeeBeeVecAVX2F;
+    using T = float;
+    using WideOps = TeeBeeAvx2FloatOps;
+    static constexpr int width = 8;
+
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V x) { _mm256_storeu_ps(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i)
+    {
+        alignas(32) float t[width];
+        for (int l = 0; l < width; ++l) t[l] = static_cast<float>(ch[l][i]);
+        return _mm256_load_ps(t);
+    }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(32) float t[width];
+        _mm256_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    static V clip(V x, V lo, V hi) { return _mm256_min_ps(hi.v, _mm256_max_ps(lo.v, x.v)); }
+    static V tanh(V x)
+    {
+        alignas(32) float t[width];
+        _mm256_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm256_load_ps(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeAvx2MixedOps : TeeBeeAvx2FloatOps
+{
+    using WideOps = TeeBeePairOps<TeeBeeAvx2Ops>;
+    static WideOps::V widen(V x)
+    {
+        return { _mm256_cvtps_pd(_mm256_castps256_ps128(x.v)), _mm256_cvtps_pd(_mm256_extractf128_ps(x.v, 1)) };
+    }
+    static V narrow(WideOps::V x)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(x.lo.v)), _mm256_cvtpd_ps(x.hi.v), 1);
+    }
+};
+#endif
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+struct TeeBeeVecAVX512
+{
+    __m512d v;
+    TeeBeeVecAVX512() = default;
+    TeeBeeVecAVX512(__m512d x) : v(x) {}
+    explicit TeeBeeVecAVX512(double x) : v(_mm512_set1_pd(x)) {}
+    friend TeeBeeVecAVX512 operator+(TeeBeeVecAVX512 a, TeeBeeVecAVX512 b) { return _mm512_add_pd(a.v, b.v); }
+    friend TeeBeeVecAVX512 operator-(TeeBeeVecAVX512 a, TeeBeeVecAVX512 b) { return _mm512_sub_pd(a.v, b.v); }
+    friend TeeBeeVecAVX512 operator*(TeeBeeVecAVX512 a, TeeBeeVecAVX512 b) { return _mm512_mul_pd(a.v, b.v); }
+    friend TeeBeeVecAVX512 operator/(TeeBeeVecAVX512 a, TeeBeeVecAVX512 b) { return _mm512_div_pd(a.v, b.v); }
+};
+
+struct TeeBeeAvx512Ops
+{
+    using V = TeeBeeVecAVX512;
+    using T = double;
+    using WideOps = TeeBeeAvx512Ops;
+    static constexpr int width = 8;
+
+    static V load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, V x) { _mm512_storeu_pd(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i)
+    {
+        return _mm512_set_pd(ch[7][i], ch[6][i], ch[5][i], ch[4][i], ch[3][i], ch[2][i], ch[1][i], ch[0][i]);
+    }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(64) double t[width];
+        _mm512_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    // Full-mask maskz forms: _mm512_min_pd/_mm512_max_pd pass an undefined operand GCC reports as
+    // used uninitialized
+    static V clip(V x, V lo, V hi)
+    {
+        return _mm512_maskz_min_pd(0xFF, hi.v, _mm512_maskz_max_pd(0xFF, lo.v, x.v));
+    }
+    static V tanh(V x)
+    {
+        alignas(64) double t[width];
+        _mm512_store_pd(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm512_load_pd(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeVecAVX512F
+{
+    __m512 v;
+    TeeBeeVecAVX512F() = default;
+    TeeBeeVecAVX512F(__m512 x) : v(x) {}
+    explicit TeeBeeVecAVX512F(double x) : v(_mm512_set1_ps(static_cast<float>(x))) {}
+    friend TeeBeeVecAVX512F operator+(TeeBeeVecAVX512F a, TeeBeeVecAVX512F b) { return _mm512_add_ps(a.v, b.v); }
+    friend TeeBeeVecAVX512F operator-(TeeBeeVecAVX512F a, TeeBeeVecAVX512F b) { return _mm512_sub_ps(a.v, b.v); }
+    friend TeeBeeVecAVX512F operator*(TeeBeeVecAVX512F a, TeeBeeVecAVX512F b) { return _mm512_mul_ps(a.v, b.v); }
+    friend TeeBeeVecAVX512F operator/(TeeBeeVecAVX512F a, TeeBeeVecAVX512F b) { return _mm512_div_ps(a.v, b.v); }
+};
+
+struct TeeBeeAvx512FloatOps
+{
+    using V = TeeBeeVecAVX512F;
+    using T = float;
+    using WideOps = TeeBeeAvx512FloatOps;
+    static constexpr int width = 16;
+
+    static V load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, V x) { _mm512_storeu_ps(p, x.v); }
+    template <class Sample> static V gather(Sample* const* ch, int i)
+    {
+        alignas(64) float t[width];
+        for (int l = 0; l < width; ++l) t[l] = static_cast<float>(ch[l][i]);
+        return _mm512_load_ps(t);
+    }
+    template <class Sample> static void scatter(Sample* const* ch, int i, V x)
+    {
+        alignas(64) float t[width];
+        _mm512_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) ch[l][i] = static_cast<Sample>(t[l]);
+    }
+    static V clip(V x, V lo, V hi) // maskz for the same reason as TeeBeeAvx512Ops::clip
+    {
+        return _mm512_maskz_min_ps(0xFFFF, hi.v, _mm512_maskz_max_ps(0xFFFF, lo.v, x.v));
+    }
+    static V tanh(V x)
+    {
+        alignas(64) float t[width];
+        _mm512_store_ps(t, x.v);
+        for (int l = 0; l < width; ++l) t[l] = std::tanh(t[l]);
+        return _mm512_load_ps(t);
+    }
+    static V widen(V x) { return x; }
+    static V narrow(V x) { return x; }
+};
+
+struct TeeBeeAvx512MixedOps : TeeBeeAvx512FloatOps
+{
+    using WideOps = TeeBeePairOps<TeeBeeAvx512Ops>;
+    // The masked forms do the same as _mm512_cvtps_pd, _mm512_extractf64x4_pd (which GCC also uses
+    // for _mm512_castps512_ps256), _mm512_cvtpd_ps and _mm512_insertf64x4 without their undefined
+    // pass-through operand, which GCC reports as used uninitialized
+    static WideOps::V widen(V x)
+    {
+        const __m256 lo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(x.v), 0));
+        const __m256 hi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(x.v), 1));
+        return { _mm512_maskz_cvtps_pd(0xFF, lo), _mm512_maskz_cvtps_pd(0xFF, hi) };
+    }
+    static V narrow(WideOps::V x)
+    {
+        const __m512d lo = _mm512_castps_pd(_mm512_castps256_ps512(_mm512_maskz_cvtpd_ps(0xFF, x.lo.v)));
+        const __m256d hi = _mm256_castps_pd(_mm512_maskz_cvtpd_ps(0xFF, x.hi.v));
+        return _mm512_castpd_ps(_mm512_mask_insertf64x4(lo, 0xFF, lo, hi, 1));
+    }
+};
+#endif
+
+// The lane blocks the ISA kernels are built for: one AVX-512 register of lanes per block
+using TeeBeeDoubleKernelBlock = TeeBeeLaneBlock<8>;
+using TeeBeeMixedKernelBlock = TeeBeeMixedLaneBlock<16>;
+using TeeBeeFloatKernelBlock = TeeBeeFloatLaneBlock<16>;
+
+/**
+ * Processes every active lane of a lane block, Ops::width lanes at a time.
+ * channels must hold Block::numLanes valid pointers (inactive lanes point at scratch buffers).
+ */
+template <class Ops, class Block, class Sample>
+inline void teeBeeProcessLaneBlock(Block& b, int activeLanes, const TeeBeeKernelSetup& setup,
+                                   Sample* const* channels, int numSamples)
+{
+    for (int lane = 0; lane < activeLanes; lane += Ops::width)
+        teeBeeProcessLanes<Ops>(setup, b, lane, channels + lane, numSamples);
+}
+
+// Per-ISA entry points, each defined in a translation unit built with that ISA enabled and
+// instantiated there for the three kernel blocks and float/double I/O
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockSSE2(Block&, int activeLanes, const TeeBeeKernelSetup&, Sample* const* channels, int numSamples);
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockAVX2(Block&, int activeLanes, const TeeBeeKernelSetup&, Sample* const* channels, int numSamples);
+template <class Block, class Sample>
+void teeBeeProcessLaneBlockAVX512(Block&, int activeLanes, const TeeBeeKernelSetup&, Sample* const* channels, int numSamples);
+
+#define TEEBEE_INSTANTIATE_LANE_BLOCK_KERNELS(fn) \
+    template void fn(TeeBeeDoubleKernelBlock&, int, const TeeBeeKernelSetup&, float* const*, int); \
+    template void fn(TeeBeeDoubleKernelBlock&, int, const TeeBeeKernelSetup&, double* const*, int); \
+    template void fn(TeeBeeMixedKernelBlock&, int, const TeeBeeKernelSetup&, float* const*, int); \
+    template void fn(TeeBeeMixedKernelBlock&, int, const TeeBeeKernelSetup&, double* const*, int); \
+    template void fn(TeeBeeFloatKernelBlock&, int, const TeeBeeKernelSetup&, float* const*, int); \
+    template void fn(TeeBeeFloatKernelBlock&, int, const TeeBeeKernelSetup&, double* const*, int);
+
+#endif // TEEBEE_SIMD_OPS_H_INCLUDED
@@ -0,0 +1,226 @@
+#pragma once
+#ifndef TEEBEE_STATE_H_INCLUDED
+#define TEEBEE_STATE_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Plug-in state and preset banks (FilterAlphaThree)
+ * - Parameters are identified by the FNV-1a hash of their ID, so state and banks written by an
+ *   older or newer build still load: unknown parameters are skipped, missing ones are left alone
+ * - State: "TBST", format version, count, then (hash, value) pairs; 112 bytes, no XML
+ * - Preset bank: header, the parameter hashes, then fixed-size records (a 32-byte name and one
+ *   value per parameter), so a memory-mapped bank is browsed and read in place without parsing
+ * - Values are plain (not normalised) parameter values; everything is little-endian
+ */
+
+enum TeeBeeParameterIndex
+{
+    PARAM_CUTOFF, PARAM_RESONANCE, PARAM_DRIVE, PARAM_MODE, PARAM_FB_HP, PARAM_FB_AMP, PARAM_AUTOMODE,
+    PARAM_QUALITY, PARAM_OVERSAMPLING, PARAM_OS_PHASE, PARAM_PRECISION, PARAM_SC_CUTOFF, PARAM_SC_RESONANCE,
+    NUM_PARAMETERS
+};
+
+// The plug-in's parameter IDs, in TeeBeeParameterIndex order
+inline constexpr const char* teeBeeParameterIds[NUM_PARAMETERS] = {
+    "cutoff", "resonance", "drive", "mode", "fbhp", "fbamp", "automode", "quality", "oversampling", "osphase", "precision",
+    "sccutoff", "scresonance"
+};
+
+// Their defaults, as in the plug-in's parameter layout (choices and toggles by index)
+inline constexpr float teeBeeParameterDefaults[NUM_PARAMETERS] = {
+    1000.0f, 20.0f, 0.0f, 0.0f, 300.0f, 50.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f
+};
+
+constexpr std::uint32_t teeBeeParameterHash(std::string_view id)
+{
+    std::uint32_t hash = 2166136261u;
+    for (char c : id) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    return hash;
+}
+
+// Index of the parameter with this hash, or -1
+constexpr int teeBeeParameterIndex(std::uint32_t hash)
+{
+    for (int i = 0; i < NUM_PARAMETERS; ++i)
+        if (teeBeeParameterHash(teeBeeParameterIds[i]) == hash) return i;
+    return -1;
+}
+
+namespace teebee_state_detail
+{
+inline void putU32(unsigned char* p, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+inline std::uint32_t getU32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+inline void putFloat(unsigned char* p, float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    putU32(p, bits);
+}
+
+inline float getFloat(const unsigned char* p)
+{
+    const std::uint32_t bits = getU32(p);
+    float value;
+    std::memcpy(&value, &bits, 4);
+    return value;
+}
+} // namespace teebee_state_detail
+
+// State
+
+inline constexpr char teeBeeStateMagic[4] = { 'T', 'B', 'S', 'T' };
+inline constexpr std::uint16_t teeBeeStateVersion = 1;
+inline constexpr std::size_t teeBeeStateSize = 8 + 8 * NUM_PARAMETERS;
+
+// Writes teeBeeStateSize bytes
+inline void teeBeeEncodeState(const float* values, unsigned char* out)
+{
+    using namespace teebee_state_detail;
+    std::memcpy(out, teeBeeStateMagic, 4);
+    out[4] = static_cast<unsigned char>(teeBeeStateVersion);
+    out[5] = static_cast<unsigned char>(teeBeeStateVersion >> 8);
+    out[6] = static_cast<unsigned char>(NUM_PARAMETERS);
+    out[7] = 0;
+    for (int i = 0; i < NUM_PARAMETERS; ++i) {
+        putU32(out + 8 + 8 * i, teeBeeParameterHash(teeBeeParameterIds[i]));
+        putFloat(out + 12 + 8 * i, values[i]);
+    }
+}
+
+// Overwrites the values the state holds; false (and nothing written) if `data` is not a
+// well-formed state, e.g. the XML of earlier builds
+inline bool teeBeeDecodeState(const void* data, std::size_t size, float* values)
+{
+    using namespace teebee_state_detail;
+    const auto* p = static_cast<const unsigned char*>(data);
+    if (p == nullptr || size < 8 || std::memcmp(p, teeBeeStateMagic, 4) != 0) return false;
+    const std::size_t count = p[6] | (p[7] << 8);
+    if (size < 8 + 8 * count) return false;
+    // Any version: the pairs are self-describing, later versions only append
+    for (std::size_t i = 0; i < count; ++i) {
+        const int index = teeBeeParameterIndex(getU32(p + 8 + 8 * i));
+        const float value = getFloat(p + 12 + 8 * i);
+        if (index >= 0 && std::isfinite(value)) values[index] = value;
+    }
+    return true;
+}
+
+// Preset Bank
+
+struct TeeBeePreset
+{
+    std::string name; // At most teeBeePresetNameSize - 1 bytes are stored
+    float values[NUM_PARAMETERS] {};
+};
+
+inline constexpr char teeBeeBankMagic[4] = { 'T', 'B', 'B', 'K' };
+inline constexpr std::uint32_t teeBeeBankVersion = 1;
+inline constexpr std::size_t teeBeePresetNameSize = 32;
+
+// The whole bank file
+inline std::vector<unsigned char> teeBeeWritePresetBank(const std::vector<TeeBeePreset>& presets)
+{
+    using namespace teebee_state_detail;
+    const std::size_t headerSize = 20 + 4 * NUM_PARAMETERS, recordSize = teeBeePresetNameSize + 4 * NUM_PARAMETERS;
+    std::vector<unsigned char> bytes(headerSize + recordSize * presets.size(), 0);
+    std::memcpy(bytes.data(), teeBeeBankMagic, 4);
+    putU32(bytes.data() + 4, teeBeeBankVersion);
+    putU32(bytes.data() + 8, NUM_PARAMETERS);
+    putU32(bytes.data() + 12, static_cast<std::uint32_t>(presets.size()));
+    putU32(bytes.data() + 16, static_cast<std::uint32_t>(recordSize));
+    for (int i = 0; i < NUM_PARAMETERS; ++i) putU32(bytes.data() + 20 + 4 * i, teeBeeParameterHash(teeBeeParameterIds[i]));
+    unsigned char* record = bytes.data() + headerSize;
+    for (const auto& preset : presets) {
+        std::memcpy(record, preset.name.data(), std::min(preset.name.size(), teeBeePresetNameSize - 1));
+        for (int i = 0; i < NUM_PARAMETERS; ++i) putFloat(record + teeBeePresetNameSize + 4 * i, preset.values[i]);
+        record += recordSize;
+    }
+    return bytes;
+}
+
+// Read-only view of a bank in memory (typically a memory-mapped file, which must outlive it)
+class TeeBeePresetBank
+{
+public:
+    // Checks the header and maps the bank's parameters to ours; false leaves the bank empty
+    bool open(const void* data, std::size_t size)
+    {
+        using namespace teebee_state_detail;
+        close();
+        const auto* p = static_cast<const unsigned char*>(data);
+        if (p == nullptr || size < 20 || std::memcmp(p, teeBeeBankMagic, 4) != 0) return false;
+        const std::size_t numParameters = getU32(p + 8), numPresets = getU32(p + 12), recordBytes = getU32(p + 16);
+        const std::size_t headerSize = 20 + 4 * numParameters;
+        if (numParameters > 4096 || recordBytes < teeBeePresetNameSize + 4 * numParameters || size < headerSize
+            || numPresets > (size - headerSize) / recordBytes)
+            return false;
+        columns.resize(numParameters);
+        for (std::size_t i = 0; i < numParameters; ++i) columns[i] = teeBeeParameterIndex(getU32(p + 20 + 4 * i));
+        records = p + headerSize;
+        recordSize = recordBytes;
+        count = static_cast<int>(numPresets);
+        return true;
+    }
+
+    void close()
+    {
+        records = nullptr;
+        count = 0;
+        columns.clear();
+    }
+
+    int getNumPresets() const { return count; }
+
+    std::string_view getName(int index) const
+    {
+        if (index < 0 || index >= count) return {};
+        const char* name = reinterpret_cast<const char*>(record(index));
+        return { name, static_cast<std::size_t>(std::find(name, name + teeBeePresetNameSize, '\0') - name) };
+    }
+
+    // Overwrites the values the bank stores for preset `index`; false if there is no such preset
+    bool getValues(int index, float* values) const
+    {
+        if (index < 0 || index >= count) return false;
+        const unsigned char* p = record(index) + teeBeePresetNameSize;
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            const float value = teebee_state_detail::getFloat(p + 4 * i);
+            if (columns[i] >= 0 && std::isfinite(value)) values[columns[i]] = value;
+        }
+        return true;
+    }
+
+    // First preset with this name, or -1
+    int findPreset(std::string_view name) const
+    {
+        for (int i = 0; i < count; ++i)
+            if (getName(i) == name) return i;
+        return -1;
+    }
+
+private:
+    const unsigned char* record(int index) const { return records + recordSize * static_cast<std::size_t>(index); }
+
+    const unsigned char* records = nullptr;
+    std::size_t recordSize = 0;
+    int count = 0;
+    std::vector<int> columns; // Our parameter index per stored column, -1 if unknown
+};
+
+#endif // TEEBEE_STATE_H_INCLUDED
@@ -2,7 +2,7 @@
 #include "PluginProcessor.h"
 
 TeeBeeAudioProcessorEditor::TeeBeeAudioProcessorEditor(TeeBeeAudioProcessor& p)
-    : AudioProcessorEditor(&p), processorRef(p)
+    : AudioProcessorEditor(&p), processorRef(p), responseDisplay(p)
 {
     setOpaque(true);
     cutoffSlider.setSliderStyle(juce::Slider::Rotary);
@@ -45,7 +45,23 @@ TeeBeeAudioProcessorEditor::TeeBeeAudioProcessorEditor(TeeBeeAudioProcessor& p)
     fbAmpLabel.attachToComponent(&fbAmpSlider, false);
     addAndMakeVisible(fbAmpSlider);
     addAndMakeVisible(fbAmpLabel);
-    modeBox.addItemList({ "TB-303", "LP 24dB", "LP 18dB", "LP 12dB", "HP 12dB", "Flat" }, 1);
+    scCutoffSlider.setSliderStyle(juce::Slider::Rotary);
+    scCutoffSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 70, 18);
+    scCutoffSlider.setTextValueSuffix(" oct");
+    scCutoffSlider.setNumDecimalPlacesToDisplay(2);
+    scCutoffLabel.setText("SC > Cutoff", juce::dontSendNotification);
+    scCutoffLabel.attachToComponent(&scCutoffSlider, false);
+    addAndMakeVisible(scCutoffSlider);
+    addAndMakeVisible(scCutoffLabel);
+    scResonanceSlider.setSliderStyle(juce::Slider::Rotary);
+    scResonanceSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 70, 18);
+    scResonanceSlider.setTextValueSuffix(" %");
+    scResonanceSlider.setNumDecimalPlacesToDisplay(1);
+    scResonanceLabel.setText("SC > Res", juce::dontSendNotification);
+    scResonanceLabel.attachToComponent(&scResonanceSlider, false);
+    addAndMakeVisible(scResonanceSlider);
+    addAndMakeVisible(scResonanceLabel);
+    modeBox.addItemList({ "TB-303", "LP 24dB", "LP 18dB", "LP 12dB", "HP 12dB", "Flat", "TB-303 ZDF" }, 1);
     modeLabel.setText("Mode", juce::dontSendNotification);
     addAndMakeVisible(modeBox);
     addAndMakeVisible(modeLabel);
@@ -53,21 +69,87 @@ TeeBeeAudioProcessorEditor::TeeBeeAudioProcessorEditor(TeeBeeAudioProcessor& p)
     automodeLabel.setText("Automation", juce::dontSendNotification);
     addAndMakeVisible(automodeToggle);
     addAndMakeVisible(automodeLabel);
+    qualityBox.addItemList({ "Exact", "Table", "Fast" }, 1);
+    qualityLabel.setText("Quality", juce::dontSendNotification);
+    addAndMakeVisible(qualityBox);
+    addAndMakeVisible(qualityLabel);
+    oversamplingBox.addItemList({ "Off", "2x", "4x", "8x" }, 1);
+    oversamplingLabel.setText("Oversampling", juce::dontSendNotification);
+    addAndMakeVisible(oversamplingBox);
+    addAndMakeVisible(oversamplingLabel);
+    osPhaseBox.addItemList({ "Minimum Phase", "Linear Phase" }, 1);
+    osPhaseLabel.setText("Oversampling Phase", juce::dontSendNotification);
+    addAndMakeVisible(osPhaseBox);
+    addAndMakeVisible(osPhaseLabel);
+    precisionBox.addItemList({ "Double", "Mixed", "Float" }, 1);
+    precisionLabel.setText("Precision", juce::dontSendNotification);
+    addAndMakeVisible(precisionBox);
+    addAndMakeVisible(precisionLabel);
     auto& params = processorRef.apvts;
     cutoffAttachment = std::make_unique<AttachFloat>(params, "cutoff", cutoffSlider);
     resonanceAttachment = std::make_unique<AttachFloat>(params, "resonance", resonanceSlider);
     driveAttachment = std::make_unique<AttachFloat>(params, "drive", driveSlider);
     fbHpAttachment = std::make_unique<AttachFloat>(params, "fbhp", fbHpSlider);
     fbAmpAttachment = std::make_unique<AttachFloat>(params, "fbamp", fbAmpSlider);
+    scCutoffAttachment = std::make_unique<AttachFloat>(params, "sccutoff", scCutoffSlider);
+    scResonanceAttachment = std::make_unique<AttachFloat>(params, "scresonance", scResonanceSlider);
     modeAttachment = std::make_unique<AttachChoice>(params, "mode", modeBox);
     automodeAttachment = std::make_unique<AttachBool>(params, "automode", automodeToggle);
-    setSize(720, 300);
+    qualityAttachment = std::make_unique<AttachChoice>(params, "quality", qualityBox);
+    oversamplingAttachment = std::make_unique<AttachChoice>(params, "oversampling", oversamplingBox);
+    osPhaseAttachment = std::make_unique<AttachChoice>(params, "osphase", osPhaseBox);
+    precisionAttachment = std::make_unique<AttachChoice>(params, "precision", precisionBox);
+    addAndMakeVisible(responseDisplay);
+    // Presets from the memory-mapped bank; picking one applies the whole set at once
+    const int numPresets = processorRef.getPresetBank().getNumPresets();
+    for (int i = 0; i < numPresets; ++i) presetBox.addItem(processorRef.getProgramName(i), i + 1);
+    presetBox.setTextWhenNothingSelected(numPresets > 0 ? "Preset" : "No preset bank");
+    presetBox.setEnabled(numPresets > 0);
+    presetBox.onChange = [this] {
+        if (const int id = presetBox.getSelectedId(); id > 0) processorRef.applyPreset(id - 1);
+    };
+    addAndMakeVisible(presetBox);
+#if TEEBEE_INSTRUMENTATION
+    cpuLabel.setFont(juce::FontOptions(12.0f));
+    cpuLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible(cpuLabel);
+    startTimerHz(4);
+#endif
+    setSize(880, 440);
 }
 
 TeeBeeAudioProcessorEditor::~TeeBeeAudioProcessorEditor() {}
 
+void TeeBeeAudioProcessorEditor::timerCallback()
+{
+#if TEEBEE_INSTRUMENTATION
+    timingWindow.drain(processorRef.getTimingRing());
+    const auto stats = timingWindow.getStats();
+    if (stats.blocks == 0) return;
+    juce::String text;
+    text << "CPU " << juce::String(stats.minCyclesPerSample, 0) << " / " << juce::String(stats.avgCyclesPerSample, 0)
+         << " / " << juce::String(stats.p99CyclesPerSample, 0) << " cycles per sample (min / avg / p99)";
+    if (const double load = stats.p99Load(processorRef.getSampleRate()); load > 0.0)
+        text << ", p99 " << juce::String(load * 100.0, 2) << "% of real time";
+    text << "   smoothing " << juce::String(stats.smoothingShare * 100.0, 1) << "%"
+         << "   clip guards " << juce::String(static_cast<juce::int64>(stats.clipGuards))
+         << "   non-finite resets " << juce::String(static_cast<juce::int64>(stats.nonFiniteResets));
+    cpuLabel.setText(text, juce::dontSendNotification);
+#endif
+}
+
 void TeeBeeAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    if (background.isValid()) g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void TeeBeeAudioProcessorEditor::drawBackground()
+{
+    const float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                             juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
     g.fillAll(juce::Colours::black);
     g.setColour(juce::Colours::white);
     g.setFont(15.0f);
@@ -76,6 +158,7 @@ void TeeBeeAudioProcessorEditor::paint(juce::Graphics& g)
 
 void TeeBeeAudioProcessorEditor::resized()
 {
+    drawBackground();
     auto area = getLocalBounds().reduced(12);
     auto topRow = area.removeFromTop(160);
     auto bottomRow = area.removeFromTop(80);
@@ -85,8 +168,20 @@ void TeeBeeAudioProcessorEditor::resized()
     resonanceSlider.setBounds(mid.reduced(8));
     auto right = topRow.removeFromLeft(160);
     driveSlider.setBounds(right.reduced(8));
+    auto options = topRow.reduced(6);
+    oversamplingBox.setBounds(options.removeFromTop(36).reduced(0, 6));
+    osPhaseBox.setBounds(options.removeFromTop(36).reduced(0, 6));
+    precisionBox.setBounds(options.removeFromTop(36).reduced(0, 6));
+    presetBox.setBounds(options.removeFromTop(36).reduced(0, 6));
     fbHpSlider.setBounds(bottomRow.removeFromLeft(140).reduced(8));
     fbAmpSlider.setBounds(bottomRow.removeFromLeft(140).reduced(8));
     modeBox.setBounds(bottomRow.removeFromLeft(120).reduced(6));
     automodeToggle.setBounds(bottomRow.removeFromLeft(100).reduced(6));
+    qualityBox.setBounds(bottomRow.removeFromLeft(100).reduced(6));
+    scCutoffSlider.setBounds(bottomRow.removeFromLeft(110).reduced(8));
+    scResonanceSlider.setBounds(bottomRow.removeFromLeft(110).reduced(8));
+    responseDisplay.setBounds(area.removeFromTop(140).reduced(0, 4));
+#if TEEBEE_INSTRUMENTATION
+    cpuLabel.setBounds(area);
+#endif
 }
\ No newline at end of file
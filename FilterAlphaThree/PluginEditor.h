@@ -3,11 +3,14 @@
 #define TEEBEE_AUDIO_PROCESSOR_EDITOR_H_INCLUDED
 
 #include <JuceHeader.h>
+#include "DSP/TeeBeeInstrumentation.h"
+#include "ResponseDisplay.h"
 
 // Forward declaration
 class TeeBeeAudioProcessor;
 
-class TeeBeeAudioProcessorEditor : public juce::AudioProcessorEditor
+class TeeBeeAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                   private juce::Timer
 {
 public:
     TeeBeeAudioProcessorEditor(TeeBeeAudioProcessor&);
@@ -17,20 +20,36 @@ public:
     void resized() override;
 
 private:
+    // Refreshes the CPU line from the processor's timing ring
+    void timerCallback() override;
+
+    // Title and backdrop, redrawn on resize only
+    void drawBackground();
+
     TeeBeeAudioProcessor& processorRef;
-    juce::Slider cutoffSlider, resonanceSlider, driveSlider, fbHpSlider, fbAmpSlider;
-    juce::ComboBox modeBox;
+    juce::Image background;
+    TeeBeeResponseDisplay responseDisplay;
+    juce::Slider cutoffSlider, resonanceSlider, driveSlider, fbHpSlider, fbAmpSlider, scCutoffSlider, scResonanceSlider;
+    juce::ComboBox modeBox, qualityBox, oversamplingBox, osPhaseBox, precisionBox, presetBox;
     juce::ToggleButton automodeToggle;
-    juce::Label cutoffLabel, resonanceLabel, driveLabel, modeLabel, fbHpLabel, fbAmpLabel, automodeLabel;
+    juce::Label cutoffLabel, resonanceLabel, driveLabel, modeLabel, fbHpLabel, fbAmpLabel, automodeLabel, qualityLabel;
+    juce::Label oversamplingLabel, osPhaseLabel, precisionLabel, scCutoffLabel, scResonanceLabel;
 
     using AttachFloat = juce::AudioProcessorValueTreeState::SliderAttachment;
     using AttachChoice = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
     using AttachBool = juce::AudioProcessorValueTreeState::ButtonAttachment;
 
     std::unique_ptr<AttachFloat> cutoffAttachment, resonanceAttachment, driveAttachment, fbHpAttachment, fbAmpAttachment;
-    std::unique_ptr<AttachChoice> modeAttachment;
+    std::unique_ptr<AttachFloat> scCutoffAttachment, scResonanceAttachment;
+    std::unique_ptr<AttachChoice> modeAttachment, qualityAttachment, oversamplingAttachment, osPhaseAttachment;
+    std::unique_ptr<AttachChoice> precisionAttachment;
     std::unique_ptr<AttachBool> automodeAttachment;
 
+#if TEEBEE_INSTRUMENTATION
+    juce::Label cpuLabel;
+    TeeBeeTimingWindow timingWindow; // The last 4096 blocks
+#endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TeeBeeAudioProcessorEditor)
 };
 
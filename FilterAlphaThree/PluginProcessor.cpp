@@ -5,18 +5,31 @@
 TeeBeeAudioProcessor::TeeBeeAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+        .withInput("Sidechain", juce::AudioChannelSet::mono(), false)),
     apvts(*this, nullptr, "PARAMS", createParameterLayout())
 {
     cutoffSmoothed.setCurrentAndTargetValue(1000.0);
-    resonanceSmoothed.setCurrentAndTargetValue(0.2);
+    resonanceSmoothed.setCurrentAndTargetValue(20.0);
     driveSmoothed.setCurrentAndTargetValue(0.0);
     fbHpSmoothed.setCurrentAndTargetValue(300.0);
-    fbAmpSmoothed.setCurrentAndTargetValue(0.5);
+    fbAmpSmoothed.setCurrentAndTargetValue(50.0);
+
+    for (int i = 0; i < NUM_PARAMETERS; ++i) {
+        handles[i] = apvts.getRawParameterValue(teeBeeParameterIds[i]);
+        parameters[i] = apvts.getParameter(teeBeeParameterIds[i]);
+        apvts.addParameterListener(teeBeeParameterIds[i], this);
+    }
+    loadPresetBank(getDefaultPresetBankFile());
+    tailWorker->addTimeSliceClient(this); // Reads the handles, so only once they are looked up
 }
 
 // Destructor
-TeeBeeAudioProcessor::~TeeBeeAudioProcessor() {}
+TeeBeeAudioProcessor::~TeeBeeAudioProcessor()
+{
+    tailWorker->removeTimeSliceClient(this); // Waits for a running slice to finish
+    for (auto* id : teeBeeParameterIds) apvts.removeParameterListener(id, this);
+}
 
 // Editor Creation
 juce::AudioProcessorEditor* TeeBeeAudioProcessor::createEditor()
@@ -38,7 +51,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout TeeBeeAudioProcessor::create
         "drive", "Drive",
         juce::NormalisableRange<float>(-24.0f, 24.0f, 0.01f), 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
-        "mode", "Mode", juce::StringArray{ "TB-303", "LP 24dB", "LP 18dB", "LP 12dB", "HP 12dB", "Flat" }, 0));
+        "mode", "Mode", juce::StringArray{ "TB-303", "LP 24dB", "LP 18dB", "LP 12dB", "HP 12dB", "Flat", "TB-303 ZDF" }, 0));
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "fbhp", "Feedback HP",
         juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f), 300.0f));
@@ -47,25 +60,117 @@ juce::AudioProcessorValueTreeState::ParameterLayout TeeBeeAudioProcessor::create
         juce::NormalisableRange<float>(0.0f, 100.0f, 0.01f), 50.0f));
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "automode", "Automation Mode", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "quality", "Saturation Quality", juce::StringArray{ "Exact", "Table", "Fast" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling", juce::StringArray{ "Off", "2x", "4x", "8x" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "osphase", "Oversampling Phase", juce::StringArray{ "Minimum Phase", "Linear Phase" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "precision", "Processing Precision", juce::StringArray{ "Double", "Mixed", "Float" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "sccutoff", "Sidechain > Cutoff",
+        juce::NormalisableRange<float>(-4.0f, 4.0f, 0.01f), 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "scresonance", "Sidechain > Resonance",
+        juce::NormalisableRange<float>(-100.0f, 100.0f, 0.1f), 0.0f));
     return { params.begin(), params.end() };
 }
 
 // Prepare to Play
 void TeeBeeAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
 {
-    (void)samplesPerBlock;
     sampleRate = newSampleRate;
-    automationMode = apvts.getRawParameterValue("automode")->load() > 0.5f;
+    preparedSampleRate.store(sampleRate, std::memory_order_relaxed);
+    automationMode = handles[PARAM_AUTOMODE]->load() > 0.5f;
+    updateSmoothingTime();
+    filter.prepare(getTotalNumOutputChannels(), sampleRate, samplesPerBlock);
+    filter.setSilenceThreshold(TeeBeeMultiChannelFilter::defaultSilenceThreshold);
+    modulationBuffer.assign(static_cast<size_t>(juce::jmax(1, samplesPerBlock)), 0.0f);
+    appliedVersion = parameterVersion.load(std::memory_order_acquire);
+    if (!pullParameters()) --appliedVersion; // A set is being written: the first block pulls it
+    filterSettled = false;
+}
+
+// Parameter Changes
+void TeeBeeAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    parameterVersion.fetch_add(1, std::memory_order_release);
+}
+
+bool TeeBeeAudioProcessor::pullParameters()
+{
+    // Seqlock read: a copy that overlaps a parameter set being written is dropped and retried next block
+    const auto sequence = presetSequence.load(std::memory_order_acquire);
+    if (sequence & 1) return false;
+    float values[NUM_PARAMETERS];
+    for (int i = 0; i < NUM_PARAMETERS; ++i) values[i] = handles[i]->load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (presetSequence.load(std::memory_order_relaxed) != sequence) return false;
+
+    const bool newAutomationMode = values[PARAM_AUTOMODE] > 0.5f;
+    if (newAutomationMode != automationMode) {
+        automationMode = newAutomationMode;
+        updateSmoothingTime();
+    }
+    const std::pair<int, juce::SmoothedValue<double>*> smoothers[] = {
+        { PARAM_CUTOFF, &cutoffSmoothed }, { PARAM_RESONANCE, &resonanceSmoothed }, { PARAM_DRIVE, &driveSmoothed },
+        { PARAM_FB_HP, &fbHpSmoothed }, { PARAM_FB_AMP, &fbAmpSmoothed }
+    };
+    for (const auto& [index, smoother] : smoothers) smoother->setTargetValue(values[index]);
+    modulationDepth.cutoffOctaves = values[PARAM_SC_CUTOFF];
+    modulationDepth.resonance = values[PARAM_SC_RESONANCE];
+    const int mode = static_cast<int>(values[PARAM_MODE]);
+    const int quality = static_cast<int>(values[PARAM_QUALITY]);
+    if (mode != filterParams.mode || quality != filterParams.quality) {
+        filterParams.mode = mode;
+        filterParams.quality = quality;
+        filterSettled = false;
+    }
+    updateOversampling(values);
+    filter.setPrecision(static_cast<int>(values[PARAM_PRECISION])); // Keeps the filter state
+    return true;
+}
+
+void TeeBeeAudioProcessor::applyParameterValues(const float* values)
+{
+    beginParameterSet();
+    for (int i = 0; i < NUM_PARAMETERS; ++i) {
+        auto* parameter = parameters[i];
+        const float normalised = parameter->convertTo0to1(values[i]);
+        if (normalised != parameter->getValue()) parameter->setValueNotifyingHost(normalised);
+    }
+    endParameterSet();
+}
+
+void TeeBeeAudioProcessor::restoreState(const juce::ValueTree& state)
+{
+    beginParameterSet();
+    apvts.replaceState(state);
+    endParameterSet();
+}
+
+void TeeBeeAudioProcessor::beginParameterSet()
+{
+    presetSequence.fetch_add(1, std::memory_order_relaxed); // Odd: pulls back off
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void TeeBeeAudioProcessor::endParameterSet()
+{
+    presetSequence.fetch_add(1, std::memory_order_release);
+    parameterVersion.fetch_add(1, std::memory_order_release); // Pull the whole set next block
+}
+
+void TeeBeeAudioProcessor::updateSmoothingTime()
+{
     const double smoothTime = automationMode ? 0.001 : 0.05;
     cutoffSmoothed.reset(sampleRate, smoothTime);
     resonanceSmoothed.reset(sampleRate, smoothTime);
     driveSmoothed.reset(sampleRate, smoothTime);
     fbHpSmoothed.reset(sampleRate, smoothTime);
     fbAmpSmoothed.reset(sampleRate, smoothTime);
-    for (auto& filter : filters) {
-        filter.setSampleRate(sampleRate);
-        filter.reset();
-    }
+    filterSettled = false;
 }
 
 // Release Resources
@@ -75,215 +180,232 @@ void TeeBeeAudioProcessor::releaseResources() {}
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool TeeBeeAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    return layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo() &&
-        layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet();
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output != layouts.getMainInputChannelSet()) return false;
+    // The sidechain is mixed to mono
+    const auto sidechain = layouts.inputBuses.size() > 1 ? layouts.getChannelSet(true, 1) : juce::AudioChannelSet::disabled();
+    return sidechain.isDisabled() || sidechain == juce::AudioChannelSet::mono() || sidechain == juce::AudioChannelSet::stereo();
 }
 #endif
 
-// Latency
-double TeeBeeAudioProcessor::getLatencyInSamples() const { return 0.0; }
-
-// Process Block
-void TeeBeeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+// Oversampling / Latency
+void TeeBeeAudioProcessor::updateOversampling(const float* values)
 {
-    juce::ScopedNoDenormals noDenormals;
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
-    if (numSamples == 0 || numChannels == 0) return;
-    automationMode = apvts.getRawParameterValue("automode")->load() > 0.5f;
-    cutoffSmoothed.setTargetValue(apvts.getRawParameterValue("cutoff")->load());
-    resonanceSmoothed.setTargetValue(apvts.getRawParameterValue("resonance")->load() * 0.01);
-    driveSmoothed.setTargetValue(apvts.getRawParameterValue("drive")->load());
-    fbHpSmoothed.setTargetValue(apvts.getRawParameterValue("fbhp")->load());
-    fbAmpSmoothed.setTargetValue(apvts.getRawParameterValue("fbamp")->load() * 0.01);
-    for (auto& filter : filters)
-    {
-        filter.setCutoff(cutoffSmoothed.getNextValue());
-        filter.setResonance(resonanceSmoothed.getNextValue());
-        filter.setDriveDb(driveSmoothed.getNextValue());
-        filter.setFeedbackHP(fbHpSmoothed.getNextValue());
-        filter.setFeedbackAmp(fbAmpSmoothed.getNextValue());
-        filter.setMode(static_cast<int>(apvts.getRawParameterValue("mode")->load()));
-    }
-    for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch)
-    {
-        auto* data = buffer.getWritePointer(ch);
-        for (int i = 0; i < numSamples; ++i)
-        {
-            data[i] = filters[ch].processSample(data[i]);
-            jassert(TeeBeeFilter::isValid(data[i]));
-        }
-    }
+    const int factor = 1 << static_cast<int>(values[PARAM_OVERSAMPLING]);
+    const auto phase = values[PARAM_OS_PHASE] > 0.5f ? TeeBeeOversampler::Phase::Linear : TeeBeeOversampler::Phase::Minimum;
+    if (factor == filter.getOversamplingFactor() && phase == filter.getOversamplingPhase()
+        && getLatencySamples() == filter.getLatencySamples())
+        return;
+    filter.setOversampling(factor, phase);
+    setLatencySamples(filter.getLatencySamples());
+    reportedLatency.store(filter.getLatencySamples(), std::memory_order_relaxed);
 }
 
-// State Management
-void TeeBeeAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+// Parameter Snapshot
+TeeBeeParameters TeeBeeAudioProcessor::getParameterSnapshot() const
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    TeeBeeParameters params;
+    params.cutoff = handles[PARAM_CUTOFF]->load();
+    params.resonance = handles[PARAM_RESONANCE]->load();
+    params.drive = handles[PARAM_DRIVE]->load();
+    params.fbHp = handles[PARAM_FB_HP]->load();
+    params.fbAmp = handles[PARAM_FB_AMP]->load();
+    params.mode = static_cast<int>(handles[PARAM_MODE]->load());
+    params.quality = static_cast<int>(handles[PARAM_QUALITY]->load());
+    return params;
 }
 
-void TeeBeeAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+// Tail Length
+double TeeBeeAudioProcessor::getTailLengthSeconds() const
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState) apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    return tailSeconds.load(std::memory_order_relaxed);
 }
 
-// Filter Implementation
-TeeBeeAudioProcessor::TeeBeeFilter::TeeBeeFilter()
+int TeeBeeAudioProcessor::useTimeSlice()
 {
-    calculateCoefficientsApprox();
-    updateFeedbackHPCoeffs();
-    reset();
-}
-
-void TeeBeeAudioProcessor::TeeBeeFilter::setSampleRate(double sr)
-{
-    if (sr >= 44100.0) {
-        sampleRate = sr;
-        twoPiOverSampleRate = 2.0 * juce::MathConstants<double>::pi / sr;
-        updateFeedbackHPCoeffs();
-        calculateCoefficientsApprox();
-        reset();
+    // Worker thread: a measurement runs up to maxSeconds of scratch audio, so only when the
+    // snapshot or sample rate differs from the last one; a latency change only re-adds
+    juce::ScopedNoDenormals noDenormals;
+    constexpr int interval = 100;
+    const auto params = getParameterSnapshot();
+    const double rate = preparedSampleRate.load(std::memory_order_relaxed);
+    const int latency = reportedLatency.load(std::memory_order_relaxed);
+    if (params != tailParams || rate != tailSampleRate) {
+        tailParams = params;
+        tailSampleRate = rate;
+        measuredTailSeconds = params.measureTailSeconds(rate, TeeBeeMultiChannelFilter::defaultSilenceThreshold);
     }
+    else if (latency == tailLatency)
+        return interval;
+    tailLatency = latency;
+    tailSeconds.store(measuredTailSeconds + latency / rate, std::memory_order_relaxed);
+    return interval;
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::reset()
+// Process Block
+void TeeBeeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
-    y1 = y2 = y3 = y4 = fb_hp_z1 = fb_inPrev = fb_lp_z1 = dc_x1 = dc_y1 = 0.0;
+    processSamples(buffer);
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setCutoff(double fc, bool updateCoeffs)
+void TeeBeeAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
 {
-    cutoff = clip(fc, 20.0, 20000.0);
-    if (updateCoeffs) calculateCoefficientsApprox();
+    processSamples(buffer);
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setResonance(double rPercent, bool updateCoeffs)
+template <class Sample>
+const float* TeeBeeAudioProcessor::mixSidechain(juce::AudioBuffer<Sample>& buffer, int start, int numSamples)
 {
-    resonanceRaw = clip(rPercent, 0.0, 100.0) * 0.01;
-    resonanceSkewed = resonanceRaw;
-    if (updateCoeffs) calculateCoefficientsApprox();
+    const auto* bus = getBus(true, 1);
+    if (!modulationDepth.isActive() || bus == nullptr || !bus->isEnabled()) return nullptr;
+    const auto sidechain = getBusBuffer(buffer, true, 1);
+    const int numSidechain = sidechain.getNumChannels();
+    if (numSidechain == 0) return nullptr;
+    const float gain = 1.0f / static_cast<float>(numSidechain);
+    float* mixed = modulationBuffer.data();
+    const Sample* first = sidechain.getReadPointer(0, start);
+    for (int i = 0; i < numSamples; ++i) mixed[i] = gain * static_cast<float>(first[i]);
+    for (int c = 1; c < numSidechain; ++c) {
+        const Sample* data = sidechain.getReadPointer(c, start);
+        for (int i = 0; i < numSamples; ++i) mixed[i] += gain * static_cast<float>(data[i]);
+    }
+    return mixed;
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setDriveDb(double db)
+template <class Sample>
+void TeeBeeAudioProcessor::processSamples(juce::AudioBuffer<Sample>& buffer)
 {
-    driveDb = clip(db, -60.0, 60.0);
-    driveFactor = std::pow(10.0, driveDb * 0.05) * 0.25;
+    juce::ScopedNoDenormals noDenormals;
+    // The main bus only: with a sidechain, the buffer carries its channels after the main ones
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    const int numChannels = mainBuffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || numChannels == 0) return;
+    TeeBeeBlockTimer timer(timingRing, numSamples, numChannels);
+
+    // Nothing to read unless a parameter changed since the last block. The version is loaded
+    // first, so a change racing with the reads below bumps it again and is picked up next block
+    const auto version = parameterVersion.load(std::memory_order_acquire);
+    if (version != appliedVersion && pullParameters()) appliedVersion = version;
+
+    // A block longer than prepared goes through in prepared-size chunks, the most the sidechain
+    // mix holds (as processModulated() segments its work)
+    const int maxChunk = static_cast<int>(modulationBuffer.size());
+    for (int start = 0; start < numSamples; start += maxChunk) {
+        const int length = juce::jmin(maxChunk, numSamples - start);
+        juce::AudioBuffer<Sample> chunk(mainBuffer.getArrayOfWritePointers(), numChannels, start, length);
+        processChunk(chunk, mixSidechain(buffer, start, length), timer);
+    }
+    if (scopeActive.load(std::memory_order_relaxed)) scopeFifo.push(mainBuffer.getReadPointer(0), numSamples);
+    const auto counters = filter.takeCounters();
+    timer.addCounts(counters.clipGuards, counters.nonFiniteResets);
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setMode(int newMode)
+template <class Sample>
+void TeeBeeAudioProcessor::processChunk(juce::AudioBuffer<Sample>& chunk, const float* modulation, TeeBeeBlockTimer& timer)
 {
-    if (newMode >= 0 && newMode < NUM_MODES) {
-        mode = newMode;
-        switch (mode) {
-        case TB_303: c0 = 0.0; c1 = 0.0; c2 = 0.0; c3 = 0.0; c4 = 1.0; break;
-        case LP_24: c0 = 0.0; c1 = 0.0; c2 = 0.0; c3 = 0.0; c4 = 1.0; break;
-        case LP_18: c0 = 0.0; c1 = 0.0; c2 = 0.0; c3 = 1.0; c4 = 0.0; break;
-        case LP_12: c0 = 0.0; c1 = 0.0; c2 = 1.0; c3 = 0.0; c4 = 0.0; break;
-        case HP_12: c0 = 1.0; c1 = -2.0; c2 = 1.0; c3 = 0.0; c4 = 0.0; break;
-        case FLAT: c0 = 1.0; c1 = 0.0; c2 = 0.0; c3 = 0.0; c4 = 0.0; break;
-        default: c0 = 1.0; c1 = 0.0; c2 = 0.0; c3 = 0.0; c4 = 0.0; break;
+    const int numChannels = chunk.getNumChannels();
+    const int numSamples = chunk.getNumSamples();
+    const bool smoothing = cutoffSmoothed.isSmoothing() || resonanceSmoothed.isSmoothing() || driveSmoothed.isSmoothing()
+                        || fbHpSmoothed.isSmoothing() || fbAmpSmoothed.isSmoothing();
+    if (!smoothing) {
+        // Static parameters: the coefficients are only recomputed after a change
+        if (!filterSettled) {
+            filterParams.cutoff = cutoffSmoothed.getCurrentValue();
+            filterParams.resonance = resonanceSmoothed.getCurrentValue();
+            filterParams.drive = driveSmoothed.getCurrentValue();
+            filterParams.fbHp = fbHpSmoothed.getCurrentValue();
+            filterParams.fbAmp = fbAmpSmoothed.getCurrentValue();
+            filter.setParameters(filterParams);
+            filterSettled = true;
         }
-        calculateCoefficientsApprox();
+        filter.processAutomated(chunk.getArrayOfWritePointers(), numChannels, numSamples, nullptr, 0, modulation,
+                                modulationDepth);
+        return;
+    }
+
+    // Smoothing: advance the smoothers one sub-block at a time and let the filter ramp its
+    // coefficients per sample towards each sub-block's end values (same values on every channel)
+    filterSettled = false;
+    for (int start = 0; start < numSamples; start += smoothingSubBlock) {
+        const int length = juce::jmin(smoothingSubBlock, numSamples - start);
+        {
+            TeeBeeCycleSection section(timer.smoothingCycles());
+            filterParams.cutoff = cutoffSmoothed.skip(length);
+            filterParams.resonance = resonanceSmoothed.skip(length);
+            filterParams.drive = driveSmoothed.skip(length);
+            filterParams.fbHp = fbHpSmoothed.skip(length);
+            filterParams.fbAmp = fbAmpSmoothed.skip(length);
+            filter.rampParameters(filterParams, length);
+        }
+        juce::AudioBuffer<Sample> subBlock(chunk.getArrayOfWritePointers(), numChannels, start, length);
+        filter.processAutomated(subBlock.getArrayOfWritePointers(), numChannels, length, nullptr, 0,
+                                modulation != nullptr ? modulation + start : nullptr, modulationDepth);
     }
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setFeedbackHP(double fc)
+// State Management
+void TeeBeeAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    feedbackHpCutoff = clip(fc, 20.0, 20000.0);
-    updateFeedbackHPCoeffs();
+    float values[NUM_PARAMETERS];
+    for (int i = 0; i < NUM_PARAMETERS; ++i) values[i] = handles[i]->load();
+    destData.setSize(teeBeeStateSize);
+    teeBeeEncodeState(values, static_cast<unsigned char*>(destData.getData()));
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::setFeedbackAmp(double amp)
+void TeeBeeAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    feedbackAmp = clip(amp, 0.0, 100.0) * 0.01;
+    float values[NUM_PARAMETERS];
+    for (int i = 0; i < NUM_PARAMETERS; ++i) values[i] = handles[i]->load();
+    if (teeBeeDecodeState(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), values)) {
+        // Into a copy of the parameter tree (a PARAM child per parameter, plain "value")
+        auto state = apvts.copyState();
+        for (int i = 0; i < NUM_PARAMETERS; ++i) {
+            auto child = state.getChildWithProperty("id", juce::String(teeBeeParameterIds[i]));
+            if (child.isValid()) child.setProperty("value", values[i], nullptr);
+        }
+        restoreState(state);
+        return;
+    }
+    // Earlier builds saved the parameter tree as XML
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    if (xmlState) restoreState(juce::ValueTree::fromXml(*xmlState));
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::updateFeedbackHPCoeffs()
+// Preset Bank
+juce::File TeeBeeAudioProcessor::getDefaultPresetBankFile()
 {
-    double x = std::exp(-2.0 * juce::MathConstants<double>::pi * feedbackHpCutoff / sampleRate);
-    fb_hp_a0 = 1.0 + x;
-    fb_hp_a1 = -(1.0 + x);
-    fb_hp_b1 = -x;
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("FilterAlpha").getChildFile("FilterAlphaPresets.tbk");
 }
 
-void TeeBeeAudioProcessor::TeeBeeFilter::calculateCoefficientsApprox()
+bool TeeBeeAudioProcessor::loadPresetBank(const juce::File& file)
 {
-    double wc = 2.0 * juce::MathConstants<double>::pi * cutoff / sampleRate;
-    a1 = -std::exp(-wc);
-    b0 = cutoff / sampleRate;
-    k = resonanceSkewed * 4.0;
-    if (mode == TB_303) {
-        k *= 1.5;
-    }
+    if (!file.existsAsFile()) return false;
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    TeeBeePresetBank bank;
+    if (mapped->getData() == nullptr || !bank.open(mapped->getData(), mapped->getSize())) return false;
+    presetBank = std::move(bank);
+    presetBankFile = std::move(mapped);
+    currentPreset = 0;
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return true;
 }
 
-double TeeBeeAudioProcessor::TeeBeeFilter::dcBlock(double in)
+bool TeeBeeAudioProcessor::applyPreset(int index)
 {
-    constexpr double R = 0.9995; // 10 Hz @ 44.1 kHz
-    double y = in - dc_x1 + R * dc_y1;
-    dc_x1 = in;
-    dc_y1 = y;
-    return y;
+    float values[NUM_PARAMETERS];
+    for (int i = 0; i < NUM_PARAMETERS; ++i) values[i] = handles[i]->load();
+    if (!presetBank.getValues(index, values)) return false;
+    applyParameterValues(values);
+    currentPreset = index;
+    return true;
 }
 
-float TeeBeeAudioProcessor::TeeBeeFilter::processSample(float in)
+const juce::String TeeBeeAudioProcessor::getProgramName(int index)
 {
-    juce::ScopedNoDenormals noDenormals;
-    double input = 0.125 * driveFactor * static_cast<double>(in);
-    input = clip(input, -2.0, 2.0);
-    auto softClip = [](double x) { return std::tanh(std::clamp(x, -6.0, 6.0)); };
-    double fb = k * feedbackAmp * y4;
-    double fb_lp = 0.9 * fb_lp_z1 + 0.1 * fb;
-    fb_lp_z1 = fb_lp;
-    fb = clip(fb_lp, -2.0, 2.0);
-    double hp = fb_hp_a0 * fb + fb_hp_a1 * fb_inPrev - fb_hp_b1 * fb_hp_z1;
-    fb_inPrev = fb;
-    fb_hp_z1 = clip(hp, -2.0, 2.0);
-    double y0 = input - hp;
-    y0 += 1e-12;
-    if (mode == TB_303) {
-        double modeGain = 1.0;
-        y0 -= k * feedbackAmp * modeGain * y4;
-        y1 += b0 * (softClip(y0) - softClip(y1));
-        y2 += b0 * (softClip(y1) - softClip(y2));
-        y3 += b0 * (softClip(y2) - softClip(y3));
-        y4 += b0 * (softClip(y3) - softClip(y4));
-        y1 = clip(y1, -2.0, 2.0);
-        y2 = clip(y2, -2.0, 2.0);
-        y3 = clip(y3, -2.0, 2.0);
-        y4 = clip(y4, -2.0, 2.0);
-        if (!std::isfinite(y1)) y1 = 0.0;
-        if (!std::isfinite(y2)) y2 = 0.0;
-        if (!std::isfinite(y3)) y3 = 0.0;
-        if (!std::isfinite(y4)) y4 = 0.0;
-        double out = y4;
-        out = softClip(out * 0.8) * 1.25;
-        float result = static_cast<float>(dcBlock(clip(out, -2.0, 2.0)));
-        return isValid(result) ? result : 0.0f;
-    }
-    else {
-        double modeGain = 0.7;
-        y0 -= k * feedbackAmp * modeGain * y4;
-        y1 = y0 + a1 * (y0 - y1);
-        y2 = y1 + a1 * (y1 - y2);
-        y3 = y2 + a1 * (y2 - y3);
-        y4 = y3 + a1 * (y3 - y4);
-        y1 = clip(y1, -2.0, 2.0);
-        y2 = clip(y2, -2.0, 2.0);
-        y3 = clip(y3, -2.0, 2.0);
-        y4 = clip(y4, -2.0, 2.0);
-        if (!std::isfinite(y1)) y1 = 0.0;
-        if (!std::isfinite(y2)) y2 = 0.0;
-        if (!std::isfinite(y3)) y3 = 0.0;
-        if (!std::isfinite(y4)) y4 = 0.0;
-        double out = 5.0 * (c0 * y0 + c1 * y1 + c2 * y2 + c3 * y3 + c4 * y4);
-        out = softClip(out * 0.8) * 1.25;
-        float result = static_cast<float>(dcBlock(clip(out, -2.0, 2.0)));
-        return isValid(result) ? result : 0.0f;
-    }
+    const auto name = presetBank.getName(index);
+    return juce::String::fromUTF8(name.data(), static_cast<int>(name.size()));
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -3,16 +3,41 @@
 #define TEEBEE_AUDIO_PROCESSOR_H_INCLUDED
 
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <vector>
+#include "DSP/TeeBeeMultiChannelFilter.h"
+#include "DSP/TeeBeeScope.h"
+#include "DSP/TeeBeeState.h"
 
 /**
  * TeeBeeFilter VST3 effect plugin for JUCE 8.0.7 (FilterAlphaThree)
  * - TB-303-style 4-pole diode ladder filter with high-pass feedback
- * - Processes incoming stereo audio (no synth/MIDI)
- * - No oversampling (direct processing)
- * - Real-time safe, double precision internally, Visual Studio 2022 / Windows 11 24H2
+ * - Processes mono, stereo and surround audio (no synth/MIDI), one SIMD lane per channel
+ * - Optional 2x/4x/8x oversampling, minimum or linear phase; the latency is reported to the host
+ * - Saturation Quality: Exact (libm tanh), Table (interpolated, ~-146 dB) or Fast (Pade, ~-108 dB)
+ * - Real-time safe, Visual Studio 2022 / Windows 11 24H2
+ * - Processing Precision: Double (default), Mixed (float ladder, double feedback path) or Float;
+ *   float and double host buffers are both processed natively
+ * - Parameters are read through cached atomic handles, and only when one has changed
+ * - Idle (silent) tracks skip the ladder once its tail has decayed; the tail length is measured
+ *   by a shared low-priority thread whenever the parameters change, and read back atomically
+ * - Each block's cycles, smoothing cycles and guard counts go to a lock-free ring the editor
+ *   reads (TeeBeeInstrumentation.h; compiled out with FILTERALPHA_INSTRUMENTATION=OFF)
+ * - While the editor's display is open, the first output channel is copied into a lock-free
+ *   scope FIFO (TeeBeeScope.h); nothing is copied otherwise
+ * - State is a 112-byte versioned binary blob (TeeBeeState.h); the XML of earlier builds still
+ *   loads. Presets come from a memory-mapped bank and are the host's program list
+ * - Automation Mode smooths parameter changes over 1 ms instead of 50 ms, to follow host
+ *   automation closely. JUCE hands over one value per parameter per block, so this is not
+ *   sample-accurate; filteralpha-batch applies automation curves at their exact samples
+ * - Optional mono/stereo sidechain bus: its signal modulates cutoff (in octaves) and resonance
+ *   at audio rate (TeeBeeAutomation.h), on every channel alike, without allocating
  */
-class TeeBeeAudioProcessor : public juce::AudioProcessor
+class TeeBeeAudioProcessor : public juce::AudioProcessor,
+                             private juce::AudioProcessorValueTreeState::Listener,
+                             private juce::TimeSliceClient
 {
 public:
     TeeBeeAudioProcessor();
@@ -24,7 +49,8 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    double getLatencyInSamples() const;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -33,12 +59,13 @@ public:
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return {}; }
+    // The loaded preset bank's presets (one empty program without a bank)
+    int getNumPrograms() override { return juce::jmax(1, presetBank.getNumPresets()); }
+    int getCurrentProgram() override { return currentPreset; }
+    void setCurrentProgram(int index) override { applyPreset(index); }
+    const juce::String getProgramName(int index) override;
     void changeProgramName(int, const juce::String&) override {}
 
     void getStateInformation(juce::MemoryBlock& destData) override;
@@ -46,46 +73,92 @@ public:
 
     juce::AudioProcessorValueTreeState apvts;
 
-private:
-    // TB-303 Filter (double precision internally)
-    struct TeeBeeFilter
-    {
-        enum Mode { TB_303, LP_24, LP_18, LP_12, HP_12, FLAT, NUM_MODES };
-
-        TeeBeeFilter();
-        void setSampleRate(double sr);
-        void reset();
-        void setCutoff(double fc, bool updateCoeffs = true);
-        void setResonance(double rPercent, bool updateCoeffs = true);
-        void setDriveDb(double db);
-        void setMode(int newMode);
-        void setFeedbackHP(double fc);
-        void setFeedbackAmp(double amp);
-        float processSample(float in);
-
-        double cutoff = 1000.0, resonanceRaw = 0.2, driveDb = 0.0, feedbackHpCutoff = 300.0, feedbackAmp = 0.5;
-        double sampleRate = 44100.0, twoPiOverSampleRate = 2.0 * juce::MathConstants<double>::pi / 44100.0;
-        int mode = TB_303;
-
-        static bool isValid(float v) { return std::isfinite(v); }
-
-    private:
-        double b0 = 1.0, a1 = 0.0, k = 0.0, g = 1.0, driveFactor = 1.0, resonanceSkewed = 0.0;
-        double y1 = 0.0, y2 = 0.0, y3 = 0.0, y4 = 0.0;
-        double c0 = 0.0, c1 = 0.0, c2 = 0.0, c3 = 0.0, c4 = 1.0;
-        double fb_hp_a0 = 1.0, fb_hp_a1 = -1.0, fb_hp_b1 = 0.0, fb_hp_z1 = 0.0, fb_inPrev = 0.0;
-        double fb_lp_z1 = 0.0; // Feedback low-pass
-        double dc_x1 = 0.0, dc_y1 = 0.0; // DC blocker state
-        void calculateCoefficientsApprox();
-        void updateFeedbackHPCoeffs();
-        double dcBlock(double in);
-        static double clip(double v, double lo, double hi) { return juce::jlimit(lo, hi, v); }
-    };
+    // Per-block timings; the editor is the one reader
+    TeeBeeTimingRing& getTimingRing() { return timingRing; }
+
+    // Output scope: while active, processBlock() pushes the first channel; the display is the one reader
+    using ScopeFifo = TeeBeeSampleFifo<32768>;
+    void setScopeActive(bool active) { scopeActive.store(active, std::memory_order_relaxed); }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    // The parameters' current values, read from the atomics (any thread)
+    TeeBeeParameters getParameterSnapshot() const;
 
-    TeeBeeFilter filters[2]; // Stereo independence
+    // Sets every parameter from plain values in TeeBeeParameterIndex order (message thread), as
+    // user edits the host is notified of: for preset changes, not for restoring state. The audio
+    // thread never pulls part of the set: a pull that overlaps it is retried next block
+    void applyParameterValues(const float* values);
+
+    // Maps a bank written by teeBeeWritePresetBank() (filteralpha-presets build); false keeps the
+    // current bank. The default bank is loaded by the constructor if it exists
+    bool loadPresetBank(const juce::File& file);
+    static juce::File getDefaultPresetBankFile();
+    const TeeBeePresetBank& getPresetBank() const { return presetBank; }
+    // Applies the bank's preset `index` as one parameter set; false if there is no such preset
+    bool applyPreset(int index);
+
+private:
+    TeeBeeMultiChannelFilter filter; // One lane per channel
     juce::SmoothedValue<double> cutoffSmoothed, resonanceSmoothed, driveSmoothed, fbHpSmoothed, fbAmpSmoothed;
+    TeeBeeModulationDepth modulationDepth;
+    std::vector<float> modulationBuffer; // The sidechain mixed to mono, prepared block size
+    // Parameter atomics and parameters in TeeBeeParameterIndex order, looked up once by ID in the constructor
+    std::array<std::atomic<float>*, NUM_PARAMETERS> handles{};
+    std::array<juce::RangedAudioParameter*, NUM_PARAMETERS> parameters{};
+    std::atomic<juce::uint32> parameterVersion{ 0 }; // Bumped by parameterChanged() on any thread
+    std::atomic<juce::uint32> presetSequence{ 0 };   // Odd while a parameter set is written (seqlock)
+    juce::uint32 appliedVersion = 0;                 // Last version pulled by the audio thread
+    TeeBeeParameters filterParams;                   // Last values given to the filter
+    bool filterSettled = false;                      // The filter holds the smoothers' current values
     bool automationMode = false;
+    static constexpr int smoothingSubBlock = 16; // Samples per smoother step while parameters glide
     double sampleRate = 44100.0;
+    TeeBeeTimingRing timingRing;
+    ScopeFifo scopeFifo;
+    std::atomic<bool> scopeActive{ false };
+    std::unique_ptr<juce::MemoryMappedFile> presetBankFile;
+    TeeBeePresetBank presetBank; // Views presetBankFile
+    int currentPreset = 0;
+
+    // Tail length: the worker re-measures it when the snapshot, sample rate or latency changes and
+    // publishes the total; getTailLengthSeconds() only loads it
+    struct TailWorker : juce::TimeSliceThread
+    {
+        TailWorker() : juce::TimeSliceThread("FilterAlpha tail") { startThread(juce::Thread::Priority::low); }
+    };
+    juce::SharedResourcePointer<TailWorker> tailWorker;
+    std::atomic<double> tailSeconds{ 0.0 };            // Measured tail plus latency
+    std::atomic<double> preparedSampleRate{ 44100.0 }; // Written by prepareToPlay()
+    std::atomic<int> reportedLatency{ 0 };             // Written by updateOversampling()
+    // Worker thread only
+    TeeBeeParameters tailParams;
+    double tailSampleRate = 0.0, measuredTailSeconds = 0.0;
+    int tailLatency = -1;
+
+    int useTimeSlice() override;
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    // Reads every parameter handle into the smoothers and `filterParams` (audio thread, after a
+    // version bump); false, with nothing changed, while a parameter set is being written
+    bool pullParameters();
+    // Brackets a write of the whole parameter set (message thread): pulls back off until the end,
+    // which bumps parameterVersion so the next block pulls the set at once
+    void beginParameterSet();
+    void endParameterSet();
+    // Loads a saved parameter tree as the set, through the tree as JUCE loads state rather than as
+    // setValueNotifyingHost() edits, which are for user changes such as presets
+    void restoreState(const juce::ValueTree& state);
+    void updateSmoothingTime();
+    // Applies the oversampling parameters (no allocation) and reports the new latency
+    void updateOversampling(const float* values);
+    // Both processBlock() overloads
+    template <class Sample> void processSamples(juce::AudioBuffer<Sample>& buffer);
+    // Up to the prepared block size of the main bus, smoothed or static
+    template <class Sample>
+    void processChunk(juce::AudioBuffer<Sample>& chunk, const float* modulation, TeeBeeBlockTimer& timer);
+    // The enabled sidechain's channels from `start` averaged into modulationBuffer (numSamples up to
+    // its size); nullptr without a sidechain or without modulation depth
+    template <class Sample> const float* mixSidechain(juce::AudioBuffer<Sample>& buffer, int start, int numSamples);
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TeeBeeAudioProcessor)
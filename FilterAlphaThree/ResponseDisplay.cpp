@@ -0,0 +1,180 @@
+#include "ResponseDisplay.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+constexpr float minDb = -60.0f, maxDb = 24.0f;
+constexpr double minFrequency = 20.0, maxFrequency = 20000.0; // Below Nyquist at every supported rate
+constexpr double scopeSeconds = 0.02;
+
+float frequencyToX(double frequency, float width)
+{
+    return width * static_cast<float>(std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency));
+}
+
+float dbToY(float db, float height)
+{
+    return juce::jmap(juce::jlimit(minDb, maxDb, db), minDb, maxDb, height, 0.0f);
+}
+} // namespace
+
+TeeBeeResponseDisplay::TeeBeeResponseDisplay(TeeBeeAudioProcessor& p)
+    : processorRef(p), scratch(4096)
+{
+    setOpaque(true);
+    processorRef.setScopeActive(true);
+    worker->addTimeSliceClient(this);
+    startTimerHz(frameRate);
+}
+
+TeeBeeResponseDisplay::~TeeBeeResponseDisplay()
+{
+    stopTimer();
+    worker->removeTimeSliceClient(this); // Waits for a running slice to finish
+    processorRef.setScopeActive(false);
+}
+
+// Message Thread
+void TeeBeeResponseDisplay::timerCallback()
+{
+    showing.store(isShowing(), std::memory_order_relaxed);
+    if (frameReady.exchange(false, std::memory_order_acquire)) repaint();
+}
+
+void TeeBeeResponseDisplay::paint(juce::Graphics& g)
+{
+    if (grid.isValid()) g.drawImage(grid, getLocalBounds().toFloat());
+    juce::Image latest;
+    {
+        const juce::SpinLock::ScopedLockType lock(frameLock);
+        latest = frame;
+    }
+    if (latest.isValid()) g.drawImage(latest, getLocalBounds().toFloat());
+}
+
+void TeeBeeResponseDisplay::resized()
+{
+    drawGrid();
+    frameScale.store(juce::Component::getApproximateScaleFactorForComponent(this), std::memory_order_relaxed);
+    frameWidth.store(getWidth(), std::memory_order_relaxed);
+    frameHeight.store(getHeight(), std::memory_order_relaxed);
+}
+
+void TeeBeeResponseDisplay::drawGrid()
+{
+    const int width = getWidth(), height = getHeight();
+    if (width <= 0 || height <= 0) {
+        grid = {};
+        return;
+    }
+    const float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    grid = juce::Image(juce::Image::RGB, juce::roundToInt(width * scale), juce::roundToInt(height * scale), true);
+    juce::Graphics g(grid);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    g.fillAll(juce::Colour(0xff101418));
+    g.setFont(juce::FontOptions(10.0f));
+    for (double f : { 50.0, 100.0, 200.0, 500.0, 1000.0, 2000.0, 5000.0, 10000.0 }) {
+        const float x = frequencyToX(f, static_cast<float>(width));
+        g.setColour(juce::Colours::white.withAlpha(0.12f));
+        g.drawVerticalLine(juce::roundToInt(x), 0.0f, static_cast<float>(height));
+        g.setColour(juce::Colours::white.withAlpha(0.4f));
+        const auto label = f >= 1000.0 ? juce::String(f / 1000.0, 0) + "k" : juce::String(static_cast<int>(f));
+        g.drawText(label, juce::roundToInt(x) + 2, height - 14, 40, 12, juce::Justification::centredLeft);
+    }
+    for (float db = maxDb - 12.0f; db > minDb; db -= 12.0f) {
+        const float y = dbToY(db, static_cast<float>(height));
+        g.setColour(juce::Colours::white.withAlpha(db == 0.0f ? 0.25f : 0.12f));
+        g.drawHorizontalLine(juce::roundToInt(y), 0.0f, static_cast<float>(width));
+        g.setColour(juce::Colours::white.withAlpha(0.4f));
+        g.drawText(juce::String(static_cast<int>(db)) + " dB", 2, juce::roundToInt(y) - 12, 50, 12,
+                   juce::Justification::centredLeft);
+    }
+}
+
+// Worker Thread
+int TeeBeeResponseDisplay::useTimeSlice()
+{
+    juce::ScopedNoDenormals noDenormals;
+    constexpr int interval = 1000 / frameRate;
+    bool changed = false;
+    auto& fifo = processorRef.getScopeFifo();
+    for (int n; (n = fifo.pop(scratch.data(), static_cast<int>(scratch.size()))) > 0; changed = true)
+        scope.write(scratch.data(), n);
+
+    const int width = frameWidth.load(std::memory_order_relaxed), height = frameHeight.load(std::memory_order_relaxed);
+    const float scale = frameScale.load(std::memory_order_relaxed);
+    if (width <= 0 || height <= 0 || !showing.load(std::memory_order_relaxed)) return interval;
+    const bool resized = width != renderedWidth || height != renderedHeight || scale != renderedScale;
+
+    // The response is only re-measured when the snapshot (or the size) differs from the last one
+    const auto params = processorRef.getParameterSnapshot();
+    const double sampleRate = processorRef.getSampleRate() > 0.0 ? processorRef.getSampleRate() : 44100.0;
+    if (resized || params != responseParams || sampleRate != responseSampleRate) {
+        measureResponse(params, sampleRate, width);
+        changed = true;
+    }
+    if (changed || resized) renderFrame(width, height, scale);
+    return interval;
+}
+
+void TeeBeeResponseDisplay::measureResponse(const TeeBeeParameters& params, double sampleRate, int width)
+{
+    // One point every other pixel, log-spaced like the grid
+    const int numPoints = std::max(2, width / 2 + 1);
+    frequencies.resize(static_cast<size_t>(numPoints));
+    magnitudesDb.resize(static_cast<size_t>(numPoints));
+    for (int i = 0; i < numPoints; ++i)
+        frequencies[static_cast<size_t>(i)] = minFrequency * std::pow(maxFrequency / minFrequency, i / (numPoints - 1.0));
+    params.measureMagnitudeResponse(sampleRate, frequencies.data(), magnitudesDb.data(), numPoints);
+    responseParams = params;
+    responseSampleRate = sampleRate;
+}
+
+void TeeBeeResponseDisplay::renderFrame(int width, int height, float scale)
+{
+    const int pixelWidth = std::max(1, juce::roundToInt(width * scale)), pixelHeight = std::max(1, juce::roundToInt(height * scale));
+    // `spare` is reused unless paint() still holds a handle to it from before the last swap
+    if (spare.isNull() || spare.getWidth() != pixelWidth || spare.getHeight() != pixelHeight || spare.getReferenceCount() > 1)
+        spare = juce::Image(juce::Image::ARGB, pixelWidth, pixelHeight, true, juce::SoftwareImageType());
+    else
+        spare.clear(spare.getBounds());
+    renderedWidth = width;
+    renderedHeight = height;
+    renderedScale = scale;
+
+    juce::Graphics g(spare);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    const float w = static_cast<float>(width), h = static_cast<float>(height);
+
+    // Scope: the last scopeSeconds from a rising zero crossing, one min/max bar per pixel column
+    const int length = juce::jlimit(2, scope.getHistorySize() / 2, static_cast<int>(scopeSeconds * responseSampleRate));
+    scopeWindow.resize(static_cast<size_t>(length));
+    scope.read(scopeWindow.data(), length);
+    g.setColour(juce::Colours::limegreen.withAlpha(0.5f));
+    const float middle = 0.5f * h, halfHeight = 0.45f * h;
+    for (int x = 0; x < width; ++x) {
+        const int begin = x * length / width, end = std::max(begin + 1, (x + 1) * length / width);
+        const auto [low, high] = std::minmax_element(scopeWindow.begin() + begin, scopeWindow.begin() + end);
+        const float top = middle - juce::jlimit(-1.0f, 1.0f, *high) * halfHeight;
+        const float bottom = middle - juce::jlimit(-1.0f, 1.0f, *low) * halfHeight;
+        g.drawVerticalLine(x, top, std::max(bottom, top + 1.0f));
+    }
+
+    // Magnitude response
+    juce::Path curve;
+    const int numPoints = static_cast<int>(magnitudesDb.size());
+    for (int i = 0; i < numPoints; ++i) {
+        const float x = w * static_cast<float>(i) / static_cast<float>(numPoints - 1);
+        const float y = dbToY(magnitudesDb[static_cast<size_t>(i)], h);
+        if (i == 0) curve.startNewSubPath(x, y);
+        else curve.lineTo(x, y);
+    }
+    g.setColour(juce::Colours::orange);
+    g.strokePath(curve, juce::PathStrokeType(1.5f));
+
+    {
+        const juce::SpinLock::ScopedLockType lock(frameLock);
+        std::swap(frame, spare);
+    }
+    frameReady.store(true, std::memory_order_release);
+}
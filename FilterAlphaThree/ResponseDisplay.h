@@ -0,0 +1,77 @@
+#pragma once
+#ifndef TEEBEE_RESPONSE_DISPLAY_H_INCLUDED
+#define TEEBEE_RESPONSE_DISPLAY_H_INCLUDED
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "DSP/TeeBeeFilter.h"
+#include "DSP/TeeBeeScope.h"
+
+class TeeBeeAudioProcessor;
+
+/**
+ * Magnitude response and output scope for the editor (FilterAlphaThree)
+ * - One low-priority TimeSliceThread, shared by every open display in the process, measures the
+ *   response from a parameter snapshot (only when the snapshot changes), drains the processor's
+ *   scope FIFO and draws both into a software image
+ * - The message thread only blits: the grid (cached, redrawn on resize) and the latest frame.
+ *   A frameRate Hz timer repaints when the worker has published a new frame, so a display
+ *   with nothing changing costs one atomic load per tick
+ * - The audio thread never waits on either: it only pushes into the lock-free scope FIFO
+ */
+class TeeBeeResponseDisplay : public juce::Component,
+                              private juce::TimeSliceClient,
+                              private juce::Timer
+{
+public:
+    static constexpr int frameRate = 30;
+
+    explicit TeeBeeResponseDisplay(TeeBeeAudioProcessor&);
+    ~TeeBeeResponseDisplay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    struct Worker : juce::TimeSliceThread
+    {
+        Worker() : juce::TimeSliceThread("FilterAlpha display") { startThread(juce::Thread::Priority::low); }
+    };
+
+    // Worker thread
+    int useTimeSlice() override;
+    void measureResponse(const TeeBeeParameters& params, double sampleRate, int width);
+    // Draws into `spare`, then swaps it with `frame`
+    void renderFrame(int width, int height, float scale);
+    // Message thread
+    void timerCallback() override;
+    void drawGrid();
+
+    TeeBeeAudioProcessor& processorRef;
+    juce::SharedResourcePointer<Worker> worker;
+    juce::Image grid; // Message thread, redrawn on resize
+
+    // Handover: the worker swaps a finished frame in under frameLock, paint() takes a handle to it
+    juce::SpinLock frameLock;
+    juce::Image frame;
+    std::atomic<bool> frameReady { false };
+    std::atomic<int> frameWidth { 0 }, frameHeight { 0 };
+    std::atomic<float> frameScale { 1.0f };
+    std::atomic<bool> showing { false }; // Set by the timer; the worker draws nothing while hidden
+
+    // Worker thread only
+    juce::Image spare;
+    TeeBeeParameters responseParams;
+    double responseSampleRate = 0.0;
+    int renderedWidth = 0, renderedHeight = 0;
+    float renderedScale = 0.0f;
+    std::vector<double> frequencies;
+    std::vector<float> magnitudesDb;
+    TeeBeeScopeBuffer scope;
+    std::vector<float> scopeWindow, scratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TeeBeeResponseDisplay)
+};
+
+#endif // TEEBEE_RESPONSE_DISPLAY_H_INCLUDED
@@ -0,0 +1,235 @@
+// Tests of sample-accurate automation and audio-rate modulation (TeeBeeMultiChannelFilter::processAutomated):
+//   1. an automated render (cutoff/resonance/drive glides, a mode switch, a sidechain) comes out
+//      the same whatever the host's block sizes, where applying the values at block starts does not
+//   2. a point takes effect at exactly its sample: the same as splitting the block there
+//   3. modulation by a silent sidechain is bit-identical to no modulation, and a constant one
+//      reaches the modulated parameters like automation points, one segment late
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+constexpr double sampleRate = 48000.0;
+constexpr int numSamples = 24000;
+constexpr int numChannels = 2;
+constexpr int maxBlock = 4096;
+
+// Saw plus a little noise on both channels (the second one quieter)
+std::vector<float> makeInput()
+{
+    std::vector<float> input(static_cast<size_t>(numChannels) * numSamples);
+    double phase = 0.0;
+    Random random(7);
+    for (int i = 0; i < numSamples; ++i) {
+        phase += 110.0 / sampleRate;
+        phase -= std::floor(phase);
+        const double noise = random.uniform() - 0.5;
+        const float x = static_cast<float>(0.6 * (2.0 * phase - 1.0) + 0.05 * noise);
+        input[i] = x;
+        input[static_cast<size_t>(numSamples) + i] = 0.5f * x;
+    }
+    return input;
+}
+
+// An audio-rate sidechain: 230 Hz sine
+std::vector<float> makeSidechain(float level)
+{
+    std::vector<float> sidechain(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        sidechain[i] = level * static_cast<float>(std::sin(2.0 * TeeBeeFilter::pi * 230.0 * i / sampleRate));
+    return sidechain;
+}
+
+// Acid-style automation, in absolute samples
+const TeeBeeParameterEvent automation[] = {
+    { 0, PARAM_CUTOFF, 200.0 },        { 0, PARAM_RESONANCE, 30.0 },      { 6000, PARAM_RESONANCE, 85.0 },
+    { 9000, PARAM_CUTOFF, 4000.0 },    { 11000, PARAM_CUTOFF, 4000.0 },   { 12000, PARAM_MODE, TeeBeeFilter::LP_24 },
+    { 15000, PARAM_CUTOFF, 350.0 },    { 15000, PARAM_DRIVE, 0.0 },       { 21000, PARAM_DRIVE, 12.0 },
+    { 23000, PARAM_CUTOFF, 900.0 },
+};
+constexpr int numPoints = static_cast<int>(sizeof(automation) / sizeof(automation[0]));
+
+TeeBeeMultiChannelFilter makeEngine()
+{
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, maxBlock);
+    engine.setParameters(makeParameters(TeeBeeFilter::TB_303, 200.0, 30.0, 0.0));
+    return engine;
+}
+
+// The values the automation has at `sample`
+TeeBeeParameters automationAt(int sample)
+{
+    TeeBeeParameters params;
+    for (int parameter : { PARAM_CUTOFF, PARAM_RESONANCE, PARAM_DRIVE }) {
+        const TeeBeeParameterEvent* before = nullptr;
+        const TeeBeeParameterEvent* after = nullptr;
+        for (const auto& point : automation) {
+            if (point.parameter != parameter) continue;
+            if (point.offset <= sample) before = &point;
+            else if (after == nullptr) after = &point;
+        }
+        double* value = teeBeeContinuousParameter(params, parameter);
+        if (before == nullptr) *value = after->value;
+        else if (after == nullptr) *value = before->value;
+        else *value = before->value + (after->value - before->value) * (sample - before->offset) / (after->offset - before->offset);
+    }
+    params.mode = sample >= 12000 ? TeeBeeFilter::LP_24 : TeeBeeFilter::TB_303;
+    return params;
+}
+
+// Renders in blocks of the given sizes (repeated), sending points the way a host does: the
+// breakpoints inside each block, and where a parameter is gliding, its value at the block's end
+std::vector<float> renderAutomated(const std::vector<int>& blockSizes, const float* sidechain,
+                                   const TeeBeeModulationDepth& depth)
+{
+    auto output = makeInput();
+    auto engine = makeEngine();
+    TeeBeeParameterEvent events[numPoints + 3];
+    for (int start = 0, b = 0, n = 0; start < numSamples; start += n, ++b) {
+        n = std::min(blockSizes[static_cast<size_t>(b) % blockSizes.size()], numSamples - start);
+        int numEvents = 0;
+        for (const auto& point : automation)
+            if ((point.offset > start || start == 0) && point.offset < start + n)
+                events[numEvents++] = { point.offset - start, point.parameter, point.value };
+        auto from = automationAt(start), to = automationAt(start + n);
+        for (int parameter : { PARAM_CUTOFF, PARAM_RESONANCE, PARAM_DRIVE }) {
+            const double value = *teeBeeContinuousParameter(to, parameter);
+            if (value != *teeBeeContinuousParameter(from, parameter)) events[numEvents++] = { n, parameter, value };
+        }
+        std::stable_sort(events, events + numEvents, [](const auto& x, const auto& y) { return x.offset < y.offset; });
+        float* channels[numChannels] = { output.data() + start, output.data() + numSamples + start };
+        engine.processAutomated(channels, numChannels, n, events, numEvents, sidechain != nullptr ? sidechain + start : nullptr,
+                                depth);
+    }
+    return output;
+}
+
+// What a host without sample-accurate automation gets: the values at each block's start
+std::vector<float> renderBlockStart(int blockSize)
+{
+    auto output = makeInput();
+    auto engine = makeEngine();
+    for (int start = 0; start < numSamples; start += blockSize) {
+        const int n = std::min(blockSize, numSamples - start);
+        engine.setParameters(automationAt(start));
+        float* channels[numChannels] = { output.data() + start, output.data() + numSamples + start };
+        engine.process(channels, numChannels, n);
+    }
+    return output;
+}
+
+// Peak difference relative to the peak of `a`, in dB
+double peakDifferenceDb(const std::vector<float>& a, const std::vector<float>& b)
+{
+    double peak = 0.0, difference = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        peak = std::max(peak, std::abs(static_cast<double>(a[i])));
+        difference = std::max(difference, std::abs(static_cast<double>(a[i]) - b[i]));
+    }
+    return difference > 0.0 ? 20.0 * std::log10(difference / peak) : -400.0;
+}
+
+void testBlockSizeIndependence()
+{
+    // Irregular sizes as well, like hosts that split blocks at loop points or tempo changes
+    std::vector<int> irregular;
+    Random random(3);
+    for (int i = 0; i < 200; ++i) irregular.push_back(1 + random.below(700));
+    const auto sidechain = makeSidechain(0.8f);
+    const TeeBeeModulationDepth depth { 1.5, 10.0 };
+    for (const bool modulated : { false, true }) {
+        const float* signal = modulated ? sidechain.data() : nullptr;
+        const auto reference = renderAutomated({ maxBlock }, signal, depth);
+        const double small = peakDifferenceDb(reference, renderAutomated({ 64 }, signal, depth));
+        const double odd = peakDifferenceDb(reference, renderAutomated(irregular, signal, depth));
+        std::printf("%s: 64-sample blocks %.1f dB, irregular blocks %.1f dB from 4096-sample blocks\n",
+                    modulated ? "automation + sidechain" : "automation", small, odd);
+        check(small < -120.0 && odd < -120.0, "automated render independent of the block size");
+    }
+    const double blockStart = peakDifferenceDb(renderBlockStart(maxBlock), renderBlockStart(64));
+    std::printf("values at block starts: 64-sample blocks %.1f dB from 4096-sample blocks\n", blockStart);
+    check(blockStart > -40.0, "block-start automation depends on the block size (the test can tell)");
+}
+
+void testPointTiming()
+{
+    auto params = makeParameters(TeeBeeFilter::TB_303, 500.0, 70.0, 0.0);
+    auto automated = makeInput(), split = makeInput();
+
+    auto engine = makeEngine();
+    const TeeBeeParameterEvent events[] = { { 0, PARAM_CUTOFF, 500.0 }, { 0, PARAM_RESONANCE, 70.0 }, { 333, PARAM_MODE, TeeBeeFilter::HP_12 } };
+    float* channels[numChannels] = { automated.data(), automated.data() + numSamples };
+    engine.processAutomated(channels, numChannels, 1000, events, 3);
+
+    auto reference = makeEngine();
+    float* splitChannels[numChannels] = { split.data(), split.data() + numSamples };
+    reference.setParameters(params);
+    reference.process(splitChannels, numChannels, 333);
+    params.mode = TeeBeeFilter::HP_12;
+    reference.setParameters(params);
+    float* rest[numChannels] = { split.data() + 333, split.data() + numSamples + 333 };
+    reference.process(rest, numChannels, 1000 - 333);
+    check(automated == split, "a point takes effect at its sample");
+}
+
+void testModulation()
+{
+    // A silent sidechain leaves every coefficient alone
+    const TeeBeeModulationDepth depth { 2.0, 25.0 };
+    const std::vector<float> silence(numSamples, 0.0f);
+    auto plain = makeInput(), modulated = makeInput();
+    {
+        auto engine = makeEngine();
+        float* channels[numChannels] = { plain.data(), plain.data() + numSamples };
+        engine.process(channels, numChannels, numSamples);
+    }
+    {
+        auto engine = makeEngine();
+        float* channels[numChannels] = { modulated.data(), modulated.data() + numSamples };
+        engine.processAutomated(channels, numChannels, numSamples, nullptr, 0, silence.data(), depth);
+    }
+    check(plain == modulated, "silent sidechain is bit-identical to no modulation");
+
+    // A constant one: the same as automation points gliding to the modulated values over the
+    // second segment (the first one still follows the silence before)
+    const std::vector<float> constant(numSamples, 0.5f);
+    auto engine = makeEngine();
+    const auto target = teeBeeModulate(engine.getParameters(), depth, 0.5);
+    auto pointed = makeInput();
+    modulated = makeInput();
+    {
+        float* channels[numChannels] = { modulated.data(), modulated.data() + numSamples };
+        engine.processAutomated(channels, numChannels, numSamples, nullptr, 0, constant.data(), depth);
+    }
+    {
+        auto reference = makeEngine();
+        const int at = TeeBeeMultiChannelFilter::modulationSegment;
+        const TeeBeeParameterEvent events[] = { { at, PARAM_CUTOFF, 200.0 }, { at, PARAM_RESONANCE, 30.0 },
+                                                { 2 * at, PARAM_CUTOFF, target.cutoff }, { 2 * at, PARAM_RESONANCE, target.resonance } };
+        float* channels[numChannels] = { pointed.data(), pointed.data() + numSamples };
+        reference.processAutomated(channels, numChannels, numSamples, events, 4);
+    }
+    const double difference = peakDifferenceDb(pointed, modulated);
+    std::printf("constant sidechain: %.1f dB from the equivalent automation points\n", difference);
+    check(difference < -120.0, "constant sidechain reaches the modulated parameters");
+    check(engine.getParameters().cutoff == 200.0, "modulation leaves the parameters alone");
+}
+} // namespace
+
+int main()
+{
+    testBlockSizeIndependence();
+    testPointTiming();
+    testModulation();
+    if (failures == 0) std::printf("all automation tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// Tests of the batch render engine (Tools/BatchRender.h):
+//   1. every output is byte-identical whether the jobs run on one thread or many
+//   2. a job without automation matches one single-threaded render of the whole file, and an
+//      automated job matches the automation points of the whole file in one block
+//   3. the pool runs every job exactly once, and a job that fails leaves the others alone
+// Writes its files under the system temp directory. Exits non-zero on failure; registered with ctest.
+
+#include "BatchRender.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+namespace fs = std::filesystem;
+
+constexpr int chunkSize = 4096;
+
+struct Input
+{
+    int numChannels, numFrames;
+    double sampleRate;
+};
+
+// Saw plus a little noise, a different pitch per channel
+std::vector<float> makeSignal(const Input& input, unsigned int seed)
+{
+    Random random(seed);
+    std::vector<float> interleaved(static_cast<size_t>(input.numFrames) * input.numChannels);
+    for (int ch = 0; ch < input.numChannels; ++ch) {
+        double phase = 0.0;
+        for (int i = 0; i < input.numFrames; ++i) {
+            phase += (70.0 + 35.0 * ch) / input.sampleRate;
+            phase -= std::floor(phase);
+            const double noise = random.uniform() - 0.5;
+            interleaved[static_cast<size_t>(i) * input.numChannels + ch] = static_cast<float>(0.5 * (2.0 * phase - 1.0) + 0.05 * noise);
+        }
+    }
+    return interleaved;
+}
+
+std::vector<float> readWav(const std::string& path)
+{
+    WavFile::Reader reader;
+    std::string error;
+    if (!reader.open(path, error)) return {};
+    std::vector<float> interleaved(static_cast<size_t>(reader.numFrames) * reader.numChannels);
+    reader.read(interleaved.data(), static_cast<int>(reader.numFrames));
+    return interleaved;
+}
+
+std::vector<char> readBytes(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+// The whole file in one block, latency compensated as the batch engine does
+std::vector<float> renderWhole(const Input& input, const std::vector<float>& signal, const BatchRender::Job& job)
+{
+    const int n = input.numFrames, numChannels = input.numChannels;
+    TeeBeeMultiChannelFilter engine;
+    const std::vector<BatchRender::CurvePoint> none;
+    const BatchRender::CurvePlayer curve(job.curve != nullptr ? *job.curve : none, input.sampleRate);
+    TeeBeeParameters params = job.settings.params;
+    curve.applyStart(params);
+    engine.prepare(numChannels, input.sampleRate, n + 16384); // Room for any oversampling latency
+    engine.setOversampling(job.settings.oversampling, job.settings.phase);
+    engine.setPrecision(job.settings.precision);
+    engine.setParameters(params);
+    engine.reset();
+    const int latency = engine.getLatencySamples(), total = n + latency;
+    std::vector<std::vector<float>> data(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(total), 0.0f));
+    std::vector<float*> channels;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < n; ++i) data[ch][i] = signal[static_cast<size_t>(i) * numChannels + ch];
+        channels.push_back(data[ch].data());
+    }
+    std::vector<TeeBeeParameterEvent> events;
+    if (!curve.isEmpty()) curve.getEvents(0, total, events);
+    engine.processAutomated(channels.data(), numChannels, total, events.data(), static_cast<int>(events.size()));
+    std::vector<float> interleaved(static_cast<size_t>(n) * numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < n; ++i) interleaved[static_cast<size_t>(i) * numChannels + ch] = data[ch][i + latency];
+    return interleaved;
+}
+
+// Peak difference relative to the peak of `a`, in dB
+double peakDifferenceDb(const std::vector<float>& a, const std::vector<float>& b)
+{
+    if (a.size() != b.size()) return 0.0;
+    double peak = 0.0, difference = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        peak = std::max(peak, std::abs(static_cast<double>(a[i])));
+        difference = std::max(difference, std::abs(static_cast<double>(a[i]) - b[i]));
+    }
+    return difference > 0.0 ? 20.0 * std::log10(difference / peak) : -400.0;
+}
+
+void testBatch(const fs::path& dir)
+{
+    const Input inputs[] = { { 2, 48000, 48000.0 }, { 1, 30001, 44100.0 }, { 3, 20000, 48000.0 },
+                             { 2, 70000, 96000.0 }, { 2, 5000, 48000.0 },  { 1, 100, 48000.0 } };
+    constexpr int numInputs = static_cast<int>(sizeof(inputs) / sizeof(inputs[0]));
+    std::vector<std::vector<float>> signals;
+    for (int f = 0; f < numInputs; ++f) {
+        signals.push_back(makeSignal(inputs[f], 11u + static_cast<unsigned int>(f)));
+        WavFile::Writer writer;
+        std::string error;
+        writer.open((dir / ("in" + std::to_string(f) + ".wav")).string(), inputs[f].numChannels, inputs[f].sampleRate, 32, error);
+        writer.write(signals.back().data(), inputs[f].numFrames);
+        writer.close();
+    }
+
+    // Settings as presets give them: oversampled, in float precision, on a bright high-pass
+    float values[3][NUM_PARAMETERS];
+    for (auto& preset : values) std::copy(std::begin(teeBeeParameterDefaults), std::end(teeBeeParameterDefaults), preset);
+    values[1][PARAM_CUTOFF] = 400.0f;
+    values[1][PARAM_RESONANCE] = 85.0f;
+    values[1][PARAM_OVERSAMPLING] = 2.0f;
+    values[1][PARAM_OS_PHASE] = 1.0f;
+    values[2][PARAM_MODE] = TeeBeeFilter::HP_12;
+    values[2][PARAM_DRIVE] = 9.0f;
+    values[2][PARAM_PRECISION] = PRECISION_FLOAT;
+    // A shared acid sweep with a mode switch
+    const std::vector<BatchRender::CurvePoint> curve = { { 0.0, PARAM_CUTOFF, 150.0 },  { 0.1, PARAM_CUTOFF, 3000.0 },
+                                                         { 0.25, PARAM_MODE, 1.0 },     { 0.4, PARAM_CUTOFF, 300.0 },
+                                                         { 0.05, PARAM_RESONANCE, 40.0 }, { 0.6, PARAM_RESONANCE, 95.0 } };
+
+    std::vector<BatchRender::Job> jobs;
+    for (int f = 0; f < numInputs; ++f) {
+        BatchRender::Job job;
+        job.input = (dir / ("in" + std::to_string(f) + ".wav")).string();
+        job.settings = BatchRender::settingsFromValues(values[f % 3]);
+        job.curve = f % 2 == 1 ? &curve : nullptr;
+        jobs.push_back(job);
+    }
+    BatchRender::Job missing;
+    missing.input = (dir / "missing.wav").string();
+    jobs.push_back(missing);
+
+    BatchRender::Options options;
+    options.blockSize = chunkSize;
+    std::vector<std::uint64_t> costs;
+    for (const auto& job : jobs) costs.push_back(BatchRender::estimateCost(job));
+    for (const int numThreads : { 1, 4 }) {
+        const std::string prefix = "out" + std::to_string(numThreads) + "_";
+        for (size_t j = 0; j < jobs.size(); ++j) jobs[j].output = (dir / (prefix + std::to_string(j) + ".wav")).string();
+        std::vector<BatchRender::Buffers> buffers(static_cast<size_t>(numThreads));
+        std::vector<BatchRender::Result> results(jobs.size());
+        BatchRender::runJobs(costs, numThreads, [&](size_t j, int worker) {
+            results[j] = BatchRender::renderJob(jobs[j], options, buffers[static_cast<size_t>(worker)]);
+        });
+        bool rendered = true;
+        for (int f = 0; f < numInputs; ++f) rendered = rendered && results[static_cast<size_t>(f)].ok;
+        check(rendered, "jobs rendered");
+        check(!results.back().ok && !results.back().error.empty(), "missing input fails its job");
+    }
+
+    bool identical = true;
+    for (int f = 0; f < numInputs; ++f) {
+        const auto single = readBytes((dir / ("out1_" + std::to_string(f) + ".wav")).string());
+        identical = identical && !single.empty() && single == readBytes((dir / ("out4_" + std::to_string(f) + ".wav")).string());
+    }
+    check(identical, "outputs identical on 1 and 4 threads");
+
+    for (int f = 0; f < numInputs; ++f) {
+        const auto batch = readWav((dir / ("out4_" + std::to_string(f) + ".wav")).string());
+        const double difference = peakDifferenceDb(renderWhole(inputs[f], signals[static_cast<size_t>(f)], jobs[static_cast<size_t>(f)]), batch);
+        std::printf("job %d (%d ch, %d frames%s): %.1f dB from one whole-file render\n", f, inputs[f].numChannels,
+                    inputs[f].numFrames, jobs[static_cast<size_t>(f)].curve != nullptr ? ", automated" : "", difference);
+        if (jobs[static_cast<size_t>(f)].curve == nullptr) check(difference == -400.0, "batch job bit-identical to a whole-file render");
+        else check(difference < -120.0, "automated batch job matches the whole-file automation");
+    }
+}
+
+void testPool()
+{
+    // Uneven costs on more threads than cores: every job once, whoever runs it
+    constexpr size_t numJobs = 257;
+    std::vector<std::uint64_t> costs(numJobs);
+    for (size_t j = 0; j < numJobs; ++j) costs[j] = (j * 7919) % 1000;
+    std::vector<std::atomic<int>> runs(numJobs);
+    std::atomic<std::uint64_t> work { 0 };
+    BatchRender::runJobs(costs, 8, [&](size_t j, int) {
+        runs[j].fetch_add(1);
+        // Something to do, so the workers overlap and steal
+        std::uint64_t x = costs[j];
+        for (std::uint64_t i = 0; i < costs[j] * 100; ++i) x = x * 6364136223846793005ull + 1;
+        work.fetch_add(x & 1);
+    });
+    check(std::all_of(runs.begin(), runs.end(), [](const auto& count) { return count.load() == 1; }), "every job runs once");
+    BatchRender::runJobs({}, 4, [&](size_t, int) { check(false, "no jobs, no calls"); });
+}
+} // namespace
+
+int main()
+{
+    const fs::path dir = fs::temp_directory_path() / "filteralpha-batch-test";
+    std::error_code error;
+    fs::remove_all(dir, error);
+    fs::create_directories(dir, error);
+    testBatch(dir);
+    testPool();
+    fs::remove_all(dir, error);
+    if (failures == 0) std::printf("all batch render tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
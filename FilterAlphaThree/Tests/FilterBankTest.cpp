@@ -0,0 +1,132 @@
+// Tests of TeeBeeFilterBank against standalone TeeBeeFilters with the same parameters, on every
+// instruction set the CPU has:
+//   1. voices of every mode and quality, allocated and released so lanes move between blocks,
+//      match their TeeBeeFilter sample for sample
+//   2. parameter changes, mode changes (crossfaded) and quality changes match the same
+//      TeeBeeParameters::applyTo() calls on the TeeBeeFilter
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeFilterBank.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+using Isa = TeeBeeFilterBank::Isa;
+constexpr double sampleRate = 48000.0;
+constexpr int maxVoices = 24, maxBlockSize = 256;
+const char* const isaNames[] = { "scalar", "sse2", "avx2", "avx512" };
+const auto table = TeeBeeCoefficientTable::forSampleRate(sampleRate);
+
+TeeBeeParameters randomParameters(Random& random)
+{
+    TeeBeeParameters params;
+    params.cutoff = 60.0 * std::pow(200.0, random.uniform());
+    params.resonance = 100.0 * random.uniform();
+    params.drive = -12.0 + 36.0 * random.uniform();
+    params.fbHp = 20.0 + 600.0 * random.uniform();
+    params.fbAmp = 100.0 * random.uniform();
+    params.mode = random.below(TeeBeeFilter::NUM_MODES);
+    params.quality = random.below(NUM_QUALITIES);
+    return params;
+}
+
+// A voice under test: its bank id, its reference filter and a saw at its own pitch
+struct Voice
+{
+    TeeBeeFilterBank::VoiceId id = TeeBeeFilterBank::invalidVoice;
+    TeeBeeFilter reference;
+    double phase = 0.0, increment = 0.0;
+    std::vector<float> bankBuffer, referenceBuffer;
+};
+
+void startVoice(TeeBeeFilterBank& bank, Voice& voice, Random& random)
+{
+    const auto params = randomParameters(random);
+    voice.id = bank.allocateVoice(params);
+    voice.reference = makeFilter(params, sampleRate, table.get()); // The bank's table too
+    voice.increment = (40.0 + 400.0 * random.uniform()) / sampleRate;
+}
+
+void render(TeeBeeFilterBank& bank, Isa isa, int numBlocks, bool changeParameters, const char* what)
+{
+    Random random(12345);
+    std::vector<Voice> voices(maxVoices);
+    for (auto& voice : voices) {
+        voice.bankBuffer.resize(maxBlockSize);
+        voice.referenceBuffer.resize(maxBlockSize);
+    }
+    bank.prepare(maxVoices, sampleRate, maxBlockSize);
+    bank.setMaxIsa(isa);
+
+    double maxDiff = 0.0;
+    bool allocated = true;
+    for (int block = 0; block < numBlocks; ++block) {
+        // Start and stop voices, so lanes are vacated, refilled and moved between blocks
+        for (auto& voice : voices) {
+            if (voice.id == TeeBeeFilterBank::invalidVoice) {
+                if (random.below(4) != 0) continue;
+                startVoice(bank, voice, random);
+                allocated &= voice.id != TeeBeeFilterBank::invalidVoice;
+            }
+            else if (random.below(16) == 0) {
+                bank.releaseVoice(voice.id);
+                voice.id = TeeBeeFilterBank::invalidVoice;
+            }
+            else if (changeParameters && random.below(3) == 0) {
+                // Mostly the same mode and quality; a third of the changes switch one or both
+                auto params = bank.getVoiceParameters(voice.id);
+                params.cutoff = std::clamp(params.cutoff * std::pow(2.0, random.uniform() - 0.5), 20.0, 20000.0);
+                params.resonance = 100.0 * random.uniform();
+                if (random.below(3) == 0) params.mode = random.below(TeeBeeFilter::NUM_MODES);
+                if (random.below(3) == 0) params.quality = random.below(NUM_QUALITIES);
+                bank.setVoiceParameters(voice.id, params);
+                params.applyTo(voice.reference);
+            }
+        }
+
+        const int numSamples = 1 + random.below(maxBlockSize);
+        float* buffers[maxVoices] = {};
+        for (size_t v = 0; v < voices.size(); ++v) {
+            auto& voice = voices[v];
+            if (voice.id == TeeBeeFilterBank::invalidVoice) continue;
+            for (int i = 0; i < numSamples; ++i) {
+                voice.bankBuffer[static_cast<size_t>(i)] = static_cast<float>(0.8 * (2.0 * voice.phase - 1.0));
+                voice.phase += voice.increment;
+                voice.phase -= std::floor(voice.phase);
+            }
+            std::copy(voice.bankBuffer.begin(), voice.bankBuffer.begin() + numSamples, voice.referenceBuffer.begin());
+            buffers[voice.id] = voice.bankBuffer.data();
+        }
+        bank.process(buffers, numSamples);
+        for (auto& voice : voices) {
+            if (voice.id == TeeBeeFilterBank::invalidVoice) continue;
+            voice.reference.processBlock(voice.referenceBuffer.data(), numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                maxDiff = std::max(maxDiff, std::fabs(static_cast<double>(voice.bankBuffer[static_cast<size_t>(i)])
+                                                      - voice.referenceBuffer[static_cast<size_t>(i)]));
+        }
+    }
+    std::printf("%-7s %-34s max difference %g\n", isaNames[static_cast<int>(isa)], what, maxDiff);
+    check(allocated, "a free voice could not be allocated");
+    check(maxDiff == 0.0, what);
+}
+} // namespace
+
+int main()
+{
+    TeeBeeFilterBank bank;
+    const Isa best = bank.setMaxIsa(Isa::AVX512);
+    for (int i = 0; i <= static_cast<int>(best); ++i) {
+        const auto isa = static_cast<Isa>(i);
+        render(bank, isa, 400, false, "fixed parameters match TeeBeeFilter");
+        render(bank, isa, 400, true, "parameter/mode changes match TeeBeeFilter");
+    }
+    if (failures == 0) std::printf("all filter bank tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
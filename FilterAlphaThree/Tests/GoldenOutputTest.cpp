@@ -0,0 +1,299 @@
+// Golden-output test: fixed stimuli rendered through every mode, sample rate and parameter preset
+// of TeeBeeMultiChannelFilter, compared against the reference renders in Tests/GoldenRenders.bin.
+//   - each render is one 2048-sample stimulus: impulse, log sweep, saw burst, white noise
+//   - presets: the plug-in defaults, a resonant overdriven "acid" setting, and a glide that ramps
+//     from a closed, resonant filter to an open one (exercises the per-sample ramp kernels)
+//   - every render is checked in several configurations (exact on the best and the scalar kernel,
+//     the table and Pade saturators, mixed and float precision), each with per-mode limits on the
+//     residual, the largest spectral difference and the peak sample difference
+// Usage: filteralpha-golden-test <GoldenRenders.bin>           compare (ctest)
+//        filteralpha-golden-test --update <GoldenRenders.bin>  re-render the references (exact,
+//                                                                double, scalar kernel)
+// Regenerate the references only for an intended change of sound, and say so in the commit.
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+
+constexpr int renderLength = 2048;
+constexpr int rampStep = 64; // Glide preset: samples per rampParameters() call
+constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+constexpr int numSampleRates = 4;
+constexpr int numPresets = 3;
+constexpr int numCases = TeeBeeFilter::NUM_MODES * numSampleRates * numPresets;
+const char* const presetNames[] = { "default", "acid", "glide" };
+
+// References are stored as 24-bit integers scaled by a power of two per render, so the step is
+// 2^-23 of the render's peak (-138 dB) however quiet it is
+constexpr char fileMagic[8] = { 'T', 'B', 'G', 'O', 'L', 'D', '0', '1' };
+constexpr int quantBits = 23;
+
+// Stimulus segments, in samples from the start of the render
+constexpr int sweepStart = 256, sawStart = 1280, noiseStart = 1792;
+
+std::vector<double> makeStimulus(double sampleRate)
+{
+    std::vector<double> input(renderLength, 0.0);
+    input[0] = 1.0;
+    // Log sweep from 20 Hz to 0.45 fs
+    const double f0 = 20.0 / sampleRate, f1 = 0.45, sweepLength = sawStart - sweepStart;
+    double phase = 0.0;
+    for (int i = sweepStart; i < sawStart; ++i) {
+        phase += f0 * std::pow(f1 / f0, (i - sweepStart) / sweepLength);
+        input[i] = 0.5 * std::sin(2.0 * TeeBeeFilter::pi * phase);
+    }
+    // Naive saw, 100-sample period
+    for (int i = sawStart; i < noiseStart; ++i) input[i] = 0.8 * (2.0 * ((i - sawStart) % 100) / 100.0 - 1.0);
+    Random random(1);
+    for (int i = noiseStart; i < renderLength; ++i) input[i] = 0.5 * random.bipolar();
+    return input;
+}
+
+TeeBeeParameters makePreset(int preset, int mode, int quality)
+{
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.quality = quality;
+    if (preset == 1) {
+        params.cutoff = 400.0;
+        params.resonance = 95.0;
+        params.drive = 18.0;
+        params.fbHp = 150.0;
+        params.fbAmp = 80.0;
+    }
+    else if (preset == 2) {
+        params.cutoff = 150.0;
+        params.resonance = 95.0;
+        params.drive = 6.0;
+        params.fbAmp = 100.0;
+    }
+    return params;
+}
+
+struct Configuration
+{
+    const char* name;
+    int quality, precision;
+    TeeBeeMultiChannelFilter::Isa isa;
+};
+
+constexpr Configuration referenceConfiguration { "reference", QUALITY_EXACT, PRECISION_DOUBLE,
+                                                 TeeBeeMultiChannelFilter::Isa::Scalar };
+
+std::vector<double> render(const Configuration& config, int mode, double sampleRate, int preset)
+{
+    TeeBeeMultiChannelFilter engine;
+    engine.setMaxIsa(config.isa);
+    engine.prepare(1, sampleRate, renderLength);
+    engine.setPrecision(config.precision);
+    auto params = makePreset(preset, mode, config.quality);
+    engine.setParameters(params);
+    auto output = makeStimulus(sampleRate);
+    if (preset != 2) {
+        double* channel = output.data();
+        engine.process(&channel, 1, renderLength);
+        return output;
+    }
+    // Glide: cutoff 150 Hz -> 8 kHz (exponential), resonance 95 -> 40 %, over the whole render
+    for (int start = 0; start < renderLength; start += rampStep) {
+        const double t = static_cast<double>(start + rampStep) / renderLength;
+        params.cutoff = 150.0 * std::pow(8000.0 / 150.0, t);
+        params.resonance = 95.0 - 55.0 * t;
+        engine.rampParameters(params, rampStep);
+        double* channel = output.data() + start;
+        engine.process(&channel, 1, rampStep);
+    }
+    return output;
+}
+
+struct Case
+{
+    int mode, rateIndex, preset;
+    std::vector<double> reference; // Dequantized
+};
+
+int caseIndex(int mode, int rateIndex, int preset) { return (mode * numSampleRates + rateIndex) * numPresets + preset; }
+
+void writeU32(std::FILE* f, std::uint32_t v)
+{
+    const unsigned char bytes[4] = { static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8),
+                                     static_cast<unsigned char>(v >> 16), static_cast<unsigned char>(v >> 24) };
+    std::fwrite(bytes, 1, 4, f);
+}
+
+bool readU32(std::FILE* f, std::uint32_t& v)
+{
+    unsigned char bytes[4];
+    if (std::fread(bytes, 1, 4, f) != 4) return false;
+    v = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+// Layout (little-endian): magic, numCases, renderLength, then per case mode, sample rate (Hz),
+// preset, exponent e and renderLength 24-bit samples q (value q * 2^(e - 23))
+bool writeReferences(const char* path)
+{
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::fwrite(fileMagic, 1, sizeof(fileMagic), f);
+    writeU32(f, numCases);
+    writeU32(f, renderLength);
+    for (int mode = 0; mode < TeeBeeFilter::NUM_MODES; ++mode) {
+        for (int r = 0; r < numSampleRates; ++r) {
+            for (int preset = 0; preset < numPresets; ++preset) {
+                writeU32(f, static_cast<std::uint32_t>(mode));
+                writeU32(f, static_cast<std::uint32_t>(sampleRates[r]));
+                writeU32(f, static_cast<std::uint32_t>(preset));
+                const auto output = render(referenceConfiguration, mode, sampleRates[r], preset);
+                double peak = 0.0;
+                for (double x : output) peak = std::max(peak, std::abs(x));
+                int exponent = 0;
+                std::frexp(peak, &exponent); // peak < 2^exponent
+                writeU32(f, static_cast<std::uint32_t>(exponent));
+                const double scale = std::ldexp(1.0, quantBits - exponent), maxQ = std::ldexp(1.0, quantBits) - 1.0;
+                for (double x : output) {
+                    const auto q = static_cast<std::int32_t>(std::lround(std::clamp(x * scale, -maxQ, maxQ)));
+                    const unsigned char bytes[3] = { static_cast<unsigned char>(q), static_cast<unsigned char>(q >> 8),
+                                                     static_cast<unsigned char>(q >> 16) };
+                    std::fwrite(bytes, 1, 3, f);
+                }
+            }
+        }
+    }
+    return std::fclose(f) == 0;
+}
+
+bool readReferences(const char* path, std::vector<Case>& cases)
+{
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    char magic[sizeof(fileMagic)];
+    std::uint32_t count = 0, length = 0;
+    bool ok = std::fread(magic, 1, sizeof(magic), f) == sizeof(magic) && std::memcmp(magic, fileMagic, sizeof(magic)) == 0
+           && readU32(f, count) && readU32(f, length) && count == numCases && length == renderLength;
+    cases.assign(numCases, {});
+    std::vector<unsigned char> bytes(3 * renderLength);
+    for (std::uint32_t c = 0; ok && c < count; ++c) {
+        std::uint32_t mode = 0, rate = 0, preset = 0, exponent = 0;
+        ok = readU32(f, mode) && readU32(f, rate) && readU32(f, preset) && readU32(f, exponent)
+          && std::fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        const auto r = std::find(sampleRates, sampleRates + numSampleRates, static_cast<double>(rate)) - sampleRates;
+        ok = ok && mode < TeeBeeFilter::NUM_MODES && r < numSampleRates && preset < numPresets;
+        if (!ok) break;
+        Case& entry = cases[caseIndex(static_cast<int>(mode), static_cast<int>(r), static_cast<int>(preset))];
+        entry = { static_cast<int>(mode), static_cast<int>(r), static_cast<int>(preset), std::vector<double>(renderLength) };
+        const double step = std::ldexp(1.0, static_cast<std::int32_t>(exponent) - quantBits);
+        for (int i = 0; i < renderLength; ++i) {
+            // Sign-extend the 24-bit sample
+            const std::int32_t q = static_cast<std::int32_t>(static_cast<std::uint32_t>(bytes[3 * i] | (bytes[3 * i + 1] << 8)
+                                                                                      | (bytes[3 * i + 2] << 16)) << 8) >> 8;
+            entry.reference[i] = q * step;
+        }
+    }
+    std::fclose(f);
+    // Every case exactly once
+    for (int c = 0; ok && c < numCases; ++c) ok = static_cast<int>(cases[c].reference.size()) == renderLength;
+    return ok;
+}
+
+struct Tolerance { double residualDb, spectralDb, peakDb; };
+
+// Measured worst cases over all rates and presets (this compiler and libm): exact -128 dB
+// residual / -131 dB spectral / -138 dB peak (the reference quantization); table and Pade within a
+// few dB of that; mixed and float -78..-96 dB residual, -76..-98 dB spectral, -91..-131 dB peak,
+// worst in the glide (float coefficient ramps) and for the 4-pole low-passes; TB_303_ZDF -112 dB with
+// Pade and -92 dB in mixed and float. The limits sit about 10 dB above, per mode, and leave room for
+// other compilers and libm implementations
+constexpr Tolerance exactTolerance[TeeBeeFilter::NUM_MODES] = {
+    { -118.0, -120.0, -125.0 }, { -118.0, -120.0, -125.0 }, { -118.0, -120.0, -125.0 },
+    { -118.0, -120.0, -125.0 }, { -115.0, -118.0, -125.0 }, { -118.0, -120.0, -125.0 },
+    { -118.0, -120.0, -125.0 },
+};
+constexpr Tolerance saturatorTolerance[TeeBeeFilter::NUM_MODES] = {
+    { -105.0, -105.0, -115.0 }, { -110.0, -110.0, -120.0 }, { -110.0, -110.0, -120.0 },
+    { -110.0, -110.0, -120.0 }, { -110.0, -110.0, -120.0 }, { -110.0, -110.0, -120.0 },
+    { -102.0, -106.0, -135.0 },
+};
+constexpr Tolerance precisionTolerance[TeeBeeFilter::NUM_MODES] = {
+    { -85.0, -85.0, -115.0 }, { -68.0, -66.0, -81.0 }, { -70.0, -69.0, -82.0 },
+    { -72.0, -71.0, -84.0 }, { -72.0, -67.0, -83.0 }, { -100.0, -88.0, -100.0 },
+    { -85.0, -83.0, -115.0 },
+};
+
+void testConfiguration(const Configuration& config, const Tolerance (&limits)[TeeBeeFilter::NUM_MODES],
+                       const std::vector<Case>& cases)
+{
+    for (int mode = 0; mode < TeeBeeFilter::NUM_MODES; ++mode) {
+        const Tolerance& limit = limits[mode];
+        Deviation worst { -400.0, -400.0, -400.0 };
+        for (int r = 0; r < numSampleRates; ++r) {
+            for (int preset = 0; preset < numPresets; ++preset) {
+                // At 100% feedback the zero-delay ladder's glide self-oscillates freely: a chaotic
+                // limit cycle that no two saturators or precisions follow sample for sample, so
+                // only Exact in double is held to it
+                if (mode == TeeBeeFilter::TB_303_ZDF && preset == 2
+                    && (config.quality != QUALITY_EXACT || config.precision != PRECISION_DOUBLE))
+                    continue;
+                const auto deviation = measure(cases[caseIndex(mode, r, preset)].reference,
+                                               render(config, mode, sampleRates[r], preset));
+                worst = { std::max(worst.residualDb, deviation.residualDb), std::max(worst.spectralDb, deviation.spectralDb),
+                          std::max(worst.peakDb, deviation.peakDb) };
+                if (deviation.residualDb > limit.residualDb || deviation.spectralDb > limit.spectralDb
+                    || deviation.peakDb > limit.peakDb) {
+                    std::printf("%s %s %.0f Hz %s: residual %.1f dB, spectral %.1f dB, peak difference %.1f dB\n",
+                                config.name, modeNames[mode], sampleRates[r], presetNames[preset], deviation.residualDb,
+                                deviation.spectralDb, deviation.peakDb);
+                    check(false, "golden output");
+                }
+            }
+        }
+        std::printf("%-9s %-5s residual %6.1f dB (limit %4.0f), spectral %6.1f dB (limit %4.0f), peak difference %6.1f dB (limit %4.0f)\n",
+                    config.name, modeNames[mode], worst.residualDb, limit.residualDb, worst.spectralDb, limit.spectralDb,
+                    worst.peakDb, limit.peakDb);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && std::strcmp(argv[1], "--update") == 0) {
+        if (!writeReferences(argv[2])) {
+            std::printf("cannot write %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("wrote %d reference renders to %s\n", numCases, argv[2]);
+        return 0;
+    }
+    if (argc != 2) {
+        std::printf("usage: %s [--update] <GoldenRenders.bin>\n", argv[0]);
+        return 2;
+    }
+    std::vector<Case> cases;
+    if (!readReferences(argv[1], cases)) {
+        std::printf("FAIL: cannot read the reference renders from %s\n", argv[1]);
+        return 1;
+    }
+
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    const Isa best = TeeBeeMultiChannelFilter::detectIsa();
+    testConfiguration({ "exact", QUALITY_EXACT, PRECISION_DOUBLE, best }, exactTolerance, cases);
+    testConfiguration(referenceConfiguration, exactTolerance, cases);
+    testConfiguration({ "table", QUALITY_TABLE, PRECISION_DOUBLE, best }, saturatorTolerance, cases);
+    testConfiguration({ "pade", QUALITY_PADE, PRECISION_DOUBLE, best }, saturatorTolerance, cases);
+    testConfiguration({ "mixed", QUALITY_EXACT, PRECISION_MIXED, best }, precisionTolerance, cases);
+    testConfiguration({ "float", QUALITY_EXACT, PRECISION_FLOAT, best }, precisionTolerance, cases);
+
+    if (failures == 0) std::printf("all golden-output tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// Tests of silence detection (TeeBeeMultiChannelFilter::setSilenceThreshold), with and without
+// oversampling:
+//   1. after a burst, the ladder is skipped only once the tail has decayed: until then the output
+//      is bit-identical to an engine without detection, that engine stays below the threshold
+//      from there on, and the skip starts after TeeBeeParameters::measureTailSeconds(), within 20 ms
+//   2. the first non-silent block after an idle stretch (input starting mid-block) comes out
+//      bit-identical to a freshly prepared engine, and leaves the engine running
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int blockSize = 64;
+constexpr float threshold = TeeBeeMultiChannelFilter::defaultSilenceThreshold;
+
+void prepare(TeeBeeMultiChannelFilter& engine, const TeeBeeParameters& params, int factor, float silenceThreshold)
+{
+    engine.prepare(numChannels, sampleRate, blockSize);
+    engine.setOversampling(factor, TeeBeeOversampler::Phase::Minimum);
+    engine.setParameters(params);
+    engine.setSilenceThreshold(silenceThreshold);
+}
+
+// Processes `input` (the same on every channel) in blockSize blocks into `output` (channel 0)
+struct Renderer
+{
+    TeeBeeMultiChannelFilter& engine;
+    std::vector<float> buffers = std::vector<float>(static_cast<size_t>(numChannels) * blockSize);
+
+    void block(const float* input, float* output, int numSamples)
+    {
+        float* channels[numChannels];
+        for (int c = 0; c < numChannels; ++c) {
+            channels[c] = buffers.data() + static_cast<size_t>(c) * blockSize;
+            std::copy(input, input + numSamples, channels[c]);
+        }
+        engine.process(channels, numChannels, numSamples);
+        std::copy(channels[0], channels[0] + numSamples, output);
+    }
+};
+
+void testIdleSkip(int mode, int factor)
+{
+    const auto params = makeParameters(mode, 800.0, 85.0, 6.0);
+    const double tailSeconds = params.measureTailSeconds(sampleRate, threshold);
+
+    // The burst measureTailSeconds() uses (50 ms at full scale), then twice the tail plus a second of silence
+    const int burst = static_cast<int>(0.05 * sampleRate);
+    const int total = burst + static_cast<int>((2.0 * tailSeconds + 1.0) * sampleRate);
+    std::vector<float> input(static_cast<size_t>(total), 0.0f);
+    std::fill(input.begin(), input.begin() + burst, 1.0f);
+
+    TeeBeeMultiChannelFilter skipping, reference;
+    prepare(skipping, params, factor, threshold);
+    prepare(reference, params, factor, 0.0f);
+    Renderer skipRender{ skipping }, referenceRender{ reference };
+    std::vector<float> skipOutput(input.size()), referenceOutput(input.size());
+    int idleFrom = -1; // First sample of the first skipped block
+    for (int offset = 0; offset < total; offset += blockSize) {
+        const int n = std::min(blockSize, total - offset);
+        skipRender.block(input.data() + offset, skipOutput.data() + offset, n);
+        referenceRender.block(input.data() + offset, referenceOutput.data() + offset, n);
+        if (idleFrom < 0 && skipping.isIdle()) idleFrom = offset + n;
+    }
+    check(idleFrom >= 0, "goes idle once the tail has decayed");
+    if (idleFrom < 0) return;
+
+    const bool identical =
+        std::memcmp(skipOutput.data(), referenceOutput.data(), static_cast<size_t>(idleFrom) * sizeof(float)) == 0;
+    float skippedPeak = 0.0f;
+    for (int i = idleFrom; i < total; ++i)
+        skippedPeak = std::max(skippedPeak, std::fabs(referenceOutput[static_cast<size_t>(i)]));
+    const double idleAfter = (idleFrom - burst) / sampleRate;
+    std::printf("%-8s %dx: tail %.3f s, idle after %.3f s, skipped peak %.2e\n", modeNames[mode], factor, tailSeconds,
+                idleAfter, static_cast<double>(skippedPeak));
+    check(identical, "output before the skip matches an engine without detection");
+    check(skippedPeak < threshold, "the skipped output had decayed below the threshold");
+    check(idleAfter >= tailSeconds, "the skip starts after the measured tail");
+    check(idleAfter <= tailSeconds + 0.02, "the skip starts within 20 ms of the measured tail");
+
+    // A saw coming back a little into a block: the engine restarted from rest, as if just prepared
+    const int resumeLength = 4096, lead = 20;
+    std::vector<float> resume(static_cast<size_t>(resumeLength), 0.0f);
+    for (int i = lead; i < resumeLength; ++i)
+        resume[static_cast<size_t>(i)] = static_cast<float>(0.8 * (2.0 * std::fmod(i * 110.0 / sampleRate, 1.0) - 1.0));
+    TeeBeeMultiChannelFilter fresh;
+    prepare(fresh, params, factor, threshold);
+    Renderer freshRender{ fresh };
+    std::vector<float> resumedOutput(resume.size()), freshOutput(resume.size());
+    bool running = true;
+    for (int offset = 0; offset < resumeLength; offset += blockSize) {
+        skipRender.block(resume.data() + offset, resumedOutput.data() + offset, blockSize);
+        freshRender.block(resume.data() + offset, freshOutput.data() + offset, blockSize);
+        running = running && !skipping.isIdle();
+    }
+    check(running, "the first non-silent block leaves idle");
+    check(std::memcmp(resumedOutput.data(), freshOutput.data(), resumedOutput.size() * sizeof(float)) == 0,
+          "resumes exactly as a freshly prepared engine");
+}
+} // namespace
+
+int main()
+{
+    for (int mode : { static_cast<int>(TeeBeeFilter::TB_303), static_cast<int>(TeeBeeFilter::LP_24),
+                      static_cast<int>(TeeBeeFilter::HP_12), static_cast<int>(TeeBeeFilter::TB_303_ZDF) })
+        for (int factor : { 1, 2 }) testIdleSkip(mode, factor);
+    if (failures == 0) std::printf("all idle skip tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// Tests of the mode crossfade (TeeBeeFilter::setMode while the ladder is running), at 44.1, 48,
+// 96 and 192 kHz:
+//   1. switching between modes with very different outputs makes no step: the largest
+//      sample-to-sample change across the switch stays within the modes' own steady-state steps
+//      (plus the fade's share of their difference), where a hard switch jumps by that difference
+//   2. the fade lasts TeeBeeFilter::modeFadeSeconds (5 ms), to the sample
+//   3. TeeBeeMultiChannelFilter crossfades a mode change identically
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+// A low-pass/high-pass pair in each direction and switches to and from the zero-delay ladder
+constexpr std::pair<int, int> switches[] = {
+    { TeeBeeFilter::TB_303, TeeBeeFilter::HP_12 }, { TeeBeeFilter::HP_12, TeeBeeFilter::LP_24 },
+    { TeeBeeFilter::FLAT, TeeBeeFilter::TB_303_ZDF }, { TeeBeeFilter::TB_303_ZDF, TeeBeeFilter::LP_12 }
+};
+
+TeeBeeParameters fadeParameters(int mode) { return makeParameters(mode, 1000.0, 40.0, 0.0); }
+
+// A 100 Hz sine: smooth, so any step in the output comes from the filter
+std::vector<float> makeInput(double sampleRate, int numSamples)
+{
+    std::vector<float> input(static_cast<size_t>(numSamples));
+    for (int i = 0; i < numSamples; ++i)
+        input[static_cast<size_t>(i)] = static_cast<float>(0.5 * std::sin(2.0 * TeeBeeFilter::pi * 100.0 * i / sampleRate));
+    return input;
+}
+
+// Largest |y[n] - y[n - 1]| over [from, to)
+double maxStep(const std::vector<float>& y, int from, int to)
+{
+    double step = 0.0;
+    for (int i = std::max(1, from); i < to; ++i)
+        step = std::max(step, std::fabs(static_cast<double>(y[static_cast<size_t>(i)]) - y[static_cast<size_t>(i - 1)]));
+    return step;
+}
+
+void testModeFade(double sampleRate, int from, int to)
+{
+    const int numSamples = static_cast<int>(0.2 * sampleRate);
+    const int switchAt = numSamples / 2 + 7;
+    const int fadeLength = static_cast<int>(std::lround(TeeBeeFilter::modeFadeSeconds * sampleRate));
+    const auto input = makeInput(sampleRate, numSamples);
+
+    // Switched with a fade; the fade's length counted a sample at a time
+    auto faded = input;
+    auto filter = makeFilter(fadeParameters(from), sampleRate);
+    filter.processBlock(faded.data(), switchAt);
+    filter.setMode(to);
+    int fadeSamples = 0;
+    for (; filter.getModeFadeRemaining() > 0 && switchAt + fadeSamples < numSamples; ++fadeSamples)
+        filter.processBlock(faded.data() + switchAt + fadeSamples, 1);
+    filter.processBlock(faded.data() + switchAt + fadeSamples, numSamples - switchAt - fadeSamples);
+
+    // Each mode on its own, settled by the time of the switch
+    auto oldOnly = input, newOnly = input;
+    makeFilter(fadeParameters(from), sampleRate).processBlock(oldOnly.data(), numSamples);
+    makeFilter(fadeParameters(to), sampleRate).processBlock(newOnly.data(), numSamples);
+    const int settled = numSamples / 4;
+    const double steadyStep = std::max(maxStep(oldOnly, settled, numSamples), maxStep(newOnly, settled, numSamples));
+    double difference = 0.0;
+    for (int i = settled; i < numSamples; ++i)
+        difference = std::max(difference, std::fabs(static_cast<double>(oldOnly[static_cast<size_t>(i)]) - newOnly[static_cast<size_t>(i)]));
+
+    // Each faded sample moves by a mix of both modes' steps plus 1 / fadeLength of their difference
+    const double limit = 1.5 * steadyStep + 2.0 * difference / fadeLength;
+    const double fadeStep = maxStep(faded, switchAt - 1, switchAt + fadeLength + 1);
+    std::printf("%6.0f Hz %-8s -> %-8s: step %.5f (limit %.5f, hard switch ~%.3f), fade %d samples (expected %d)\n",
+                sampleRate, modeNames[from], modeNames[to], fadeStep, limit, difference, fadeSamples, fadeLength);
+    check(difference > 10.0 * limit, "the modes differ enough for a hard switch to show");
+    check(fadeStep <= limit, "no step at the mode switch");
+    check(fadeSamples == fadeLength, "the fade lasts modeFadeSeconds");
+
+    // The engine, one channel, switching at the same sample
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(1, sampleRate, numSamples);
+    engine.setParameters(fadeParameters(from));
+    auto engineOutput = input;
+    float* channels[1] = { engineOutput.data() };
+    engine.process(channels, 1, switchAt);
+    engine.setParameters(fadeParameters(to));
+    channels[0] += switchAt;
+    engine.process(channels, 1, numSamples - switchAt);
+    check(std::memcmp(engineOutput.data(), faded.data(), faded.size() * sizeof(float)) == 0,
+          "TeeBeeMultiChannelFilter crossfades like TeeBeeFilter");
+}
+} // namespace
+
+int main()
+{
+    for (double sampleRate : sampleRates)
+        for (const auto& [from, to] : switches) testModeFade(sampleRate, from, to);
+    if (failures == 0) std::printf("all mode crossfade tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// Tests of TeeBeeOversampler at 2x, 4x and 8x, in both phases, on tones that fit the FFT exactly:
+//   1. linear phase: the round trip's impulse response peaks at getLatencySamples(); minimum
+//      phase: getLatencySamples() is the round trip's group delay at DC (the impulse response's
+//      centroid), rounded to the nearest sample
+//   2. images of host-rate tones up to 0.9 x Nyquist are at least 90 dB down in the upsampled signal
+//   3. oversampled tones from 1.1 x host Nyquist up alias into the host band at least 90 dB down
+//   4. the round trip is flat within 0.001 dB up to 0.9 x Nyquist
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeOversampler.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+using Phase = TeeBeeOversampler::Phase;
+
+constexpr int fftSize = 4096;  // At the host rate; tones run a whole number of cycles in it
+constexpr int blockSize = 256; // Divides fftSize
+constexpr double amplitude = 0.5;
+constexpr double rejectionDb = 90.0, rippleDb = 0.001;
+
+// fftSize samples of settling, then the fftSize * factor samples analysed
+std::vector<float> makeTone(int bin, int factor)
+{
+    const int length = 2 * fftSize * factor;
+    std::vector<float> tone(static_cast<size_t>(length));
+    for (int i = 0; i < length; ++i)
+        tone[static_cast<size_t>(i)] = static_cast<float>(amplitude * std::sin(2.0 * TeeBeeFilter::pi * bin * i / (fftSize * factor)));
+    return tone;
+}
+
+// |X[k]| of the last n samples for k up to n / 2, unwindowed: the tones are periodic in it
+std::vector<double> magnitudes(const std::vector<float>& signal, size_t n)
+{
+    std::vector<std::complex<double>> x(n);
+    for (size_t i = 0; i < n; ++i) x[i] = signal[signal.size() - n + i];
+    fft(x);
+    std::vector<double> result(n / 2 + 1);
+    for (size_t k = 0; k <= n / 2; ++k) result[k] = std::abs(x[k]);
+    return result;
+}
+
+TeeBeeOversampler makeOversampler(int factor, Phase phase)
+{
+    TeeBeeOversampler oversampler;
+    oversampler.prepare(1, blockSize);
+    oversampler.setup(factor, phase);
+    return oversampler;
+}
+
+// Host rate in and out; `oversampled`, if given, replaces the upsampled signal before downsampling
+// and receives it otherwise
+std::vector<float> process(TeeBeeOversampler& oversampler, const std::vector<float>& input,
+                           std::vector<float>* oversampled = nullptr, bool replace = false)
+{
+    const int factor = oversampler.getFactor(), length = static_cast<int>(input.size());
+    std::vector<float> output(input.size());
+    if (oversampled != nullptr && !replace) oversampled->resize(input.size() * static_cast<size_t>(factor));
+    for (int offset = 0; offset < length; offset += blockSize) {
+        const float* in[1] = { input.data() };
+        float* up = oversampler.upsample(in, 1, offset, blockSize)[0];
+        if (oversampled != nullptr) {
+            float* os = oversampled->data() + static_cast<size_t>(offset) * factor;
+            if (replace) std::copy(os, os + blockSize * factor, up);
+            else std::copy(up, up + blockSize * factor, os);
+        }
+        float* out[1] = { output.data() };
+        oversampler.downsample(out, 1, offset, blockSize);
+    }
+    return output;
+}
+
+void testLatency(int factor, Phase phase, const char* name)
+{
+    auto oversampler = makeOversampler(factor, phase);
+    std::vector<float> impulse(1024, 0.0f);
+    impulse[0] = 1.0f;
+    const auto response = process(oversampler, impulse);
+    int peak = 0;
+    double sum = 0.0, moment = 0.0;
+    for (int i = 0; i < static_cast<int>(response.size()); ++i) {
+        const double h = response[static_cast<size_t>(i)];
+        if (std::fabs(h) > std::fabs(response[static_cast<size_t>(peak)])) peak = i;
+        sum += h;
+        moment += i * h;
+    }
+    const double centroid = moment / sum;
+    const int latency = oversampler.getLatencySamples();
+    std::printf("%dx %-7s: latency %d, impulse peak %d, group delay at DC %.3f\n", factor, name, latency, peak, centroid);
+    if (phase == Phase::Linear) check(peak == latency, "linear phase: the impulse peaks at the reported latency");
+    else check(std::lround(centroid) == latency, "minimum phase: the reported latency is the group delay at DC");
+}
+
+void testImagesAndRipple(int factor, Phase phase, const char* name)
+{
+    double worstImage = 0.0, minGain = 1e9, maxGain = 0.0;
+    const int edge = static_cast<int>(0.9 * fftSize / 2);
+    for (int bin = 1; bin <= edge; bin += (bin < edge - 64 ? 37 : 1)) {
+        auto oversampler = makeOversampler(factor, phase);
+        const auto tone = makeTone(bin, 1);
+        std::vector<float> upsampled;
+        const auto output = process(oversampler, tone, &upsampled);
+
+        const auto up = magnitudes(upsampled, static_cast<size_t>(fftSize) * factor);
+        double image = 0.0;
+        for (size_t k = fftSize / 2 + 1; k < up.size(); ++k) image = std::max(image, up[k]);
+        worstImage = std::max(worstImage, image / up[static_cast<size_t>(bin)]);
+
+        const double gain = magnitudes(output, fftSize)[static_cast<size_t>(bin)] / (amplitude * fftSize / 2);
+        minGain = std::min(minGain, gain);
+        maxGain = std::max(maxGain, gain);
+    }
+    const double ripple = std::max(std::fabs(toDb(minGain)), std::fabs(toDb(maxGain)));
+    std::printf("%dx %-7s: images %.1f dB, passband %+.5f/%+.5f dB\n", factor, name, toDb(worstImage), toDb(minGain),
+                toDb(maxGain));
+    check(toDb(worstImage) <= -rejectionDb, "images rejected by 90 dB");
+    check(ripple <= rippleDb, "passband flat within 0.001 dB up to 0.9 x Nyquist");
+}
+
+void testAliasing(int factor, Phase phase, const char* name)
+{
+    double worstAlias = 0.0;
+    const int first = static_cast<int>(std::ceil(1.1 * fftSize / 2)), last = fftSize * factor / 2 - 1;
+    for (int bin = first; bin <= last; bin += (bin < first + 64 ? 1 : 53)) {
+        auto oversampler = makeOversampler(factor, phase);
+        auto tone = makeTone(bin, factor);
+        const auto output = process(oversampler, std::vector<float>(static_cast<size_t>(2 * fftSize), 0.0f), &tone, true);
+        const auto host = magnitudes(output, fftSize);
+        worstAlias = std::max(worstAlias, *std::max_element(host.begin(), host.end()) / (amplitude * fftSize / 2));
+    }
+    std::printf("%dx %-7s: aliases %.1f dB\n", factor, name, toDb(worstAlias));
+    check(toDb(worstAlias) <= -rejectionDb, "aliases rejected by 90 dB");
+}
+} // namespace
+
+int main()
+{
+    for (const auto& [phase, name] : { std::pair(Phase::Minimum, "minimum"), std::pair(Phase::Linear, "linear") }) {
+        for (int factor : { 2, 4, 8 }) {
+            testLatency(factor, phase, name);
+            testImagesAndRipple(factor, phase, name);
+            testAliasing(factor, phase, name);
+        }
+    }
+    if (failures == 0) std::printf("all oversampler tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
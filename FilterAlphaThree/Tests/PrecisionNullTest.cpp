@@ -0,0 +1,197 @@
+// Null tests of the mixed and float precisions (TeeBeeMultiChannelFilter::setPrecision):
+//   1. every mode rendered in mixed and float must stay within a residual / spectral deviation
+//      budget of the double render
+//   2. in every precision, every SIMD kernel must match the scalar kernel bit for bit, with
+//      float and with double buffers
+//   3. double buffers in double precision must match TeeBeeFilter::processBlock(double*) bit for
+//      bit, and round to exactly the float-buffer output
+//   4. switching precision mid-stream must carry the state over (no restart from rest)
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+
+constexpr double sampleRate = 48000.0;
+constexpr int fftSize = 16384;
+constexpr int numChannels = 16; // One full float/mixed block
+const char* const precisionNames[] = { "double", "mixed", "float" };
+
+// Saw sweeping 55..880 Hz plus a little noise: drives the ladder through its soft-clip range
+// and keeps every lane busy at low levels too
+std::vector<float> makeInput()
+{
+    std::vector<float> input(fftSize);
+    double phase = 0.0;
+    Random random(1);
+    for (int i = 0; i < fftSize; ++i) {
+        const double f = 55.0 * std::pow(16.0, static_cast<double>(i) / fftSize);
+        phase += f / sampleRate;
+        phase -= std::floor(phase);
+        const double noise = random.uniform() - 0.5;
+        input[i] = static_cast<float>(0.8 * (2.0 * phase - 1.0) + 0.05 * noise);
+    }
+    return input;
+}
+
+TeeBeeParameters nullParameters(int mode, int quality = QUALITY_EXACT)
+{
+    return makeParameters(mode, 600.0, 90.0, 30.0, quality);
+}
+
+// numChannels copies of the input at decreasing levels, channel after channel
+template <class Sample>
+std::vector<Sample> makeBuffers(const std::vector<float>& input)
+{
+    std::vector<Sample> buffers(static_cast<size_t>(numChannels) * fftSize);
+    for (int c = 0; c < numChannels; ++c)
+        for (int i = 0; i < fftSize; ++i)
+            buffers[static_cast<size_t>(c) * fftSize + i] = static_cast<Sample>(input[i] * (1.0f - 0.05f * c));
+    return buffers;
+}
+
+template <class Sample>
+void process(TeeBeeMultiChannelFilter& engine, std::vector<Sample>& buffers, int offset, int numSamples)
+{
+    Sample* channels[numChannels];
+    for (int c = 0; c < numChannels; ++c) channels[c] = buffers.data() + static_cast<size_t>(c) * fftSize + offset;
+    engine.process(channels, numChannels, numSamples);
+}
+
+template <class Sample>
+std::vector<Sample> render(const std::vector<float>& input, const TeeBeeParameters& params, int precision,
+                           TeeBeeMultiChannelFilter::Isa isa = TeeBeeMultiChannelFilter::Isa::AVX512)
+{
+    TeeBeeMultiChannelFilter engine;
+    engine.setMaxIsa(isa);
+    engine.prepare(numChannels, sampleRate, 512);
+    engine.setPrecision(precision);
+    engine.setParameters(params);
+    auto buffers = makeBuffers<Sample>(input);
+    process(engine, buffers, 0, fftSize);
+    return buffers;
+}
+
+// Worst channel of measure()
+Deviation measureChannels(const std::vector<float>& reference, const std::vector<float>& test)
+{
+    Deviation worst { -400.0, -400.0, -400.0 };
+    for (int c = 0; c < numChannels; ++c) {
+        const auto deviation = measure(reference.data() + static_cast<size_t>(c) * fftSize,
+                                       test.data() + static_cast<size_t>(c) * fftSize, fftSize);
+        worst.residualDb = std::max(worst.residualDb, deviation.residualDb);
+        worst.spectralDb = std::max(worst.spectralDb, deviation.spectralDb);
+        worst.peakDb = std::max(worst.peakDb, deviation.peakDb);
+    }
+    return worst;
+}
+
+// Measured at -103..-113 dB residual and -87..-101 dB spectral deviation (worst: TB_303, the
+// only mode whose float stages all saturate); the limits leave room for other compilers and
+// libm tanhf implementations. TB_303_ZDF measures -89 dB: at this resonance its loop gain is
+// just short of self-oscillation, and the long ringing carries the rounding along
+void testPrecisionNull(const std::vector<float>& input)
+{
+    constexpr double maxSpectralDb = -80.0;
+    for (int mode = 0; mode < TeeBeeFilter::NUM_MODES; ++mode) {
+        const double maxResidualDb = mode == TeeBeeFilter::TB_303_ZDF ? -85.0 : -95.0;
+        const auto params = nullParameters(mode);
+        const auto reference = render<float>(input, params, PRECISION_DOUBLE);
+        for (int precision : { PRECISION_MIXED, PRECISION_FLOAT }) {
+            const auto deviation = measureChannels(reference, render<float>(input, params, precision));
+            std::printf("%-5s %-6s residual %.1f dB (limit %.0f), spectral deviation %.1f dB (limit %.0f)\n",
+                        modeNames[mode], precisionNames[precision], deviation.residualDb, maxResidualDb,
+                        deviation.spectralDb, maxSpectralDb);
+            check(deviation.residualDb <= maxResidualDb && deviation.spectralDb <= maxSpectralDb, "precision null test");
+        }
+    }
+}
+
+template <class Sample>
+void testSimdMatchesScalar(const std::vector<float>& input)
+{
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    for (int precision = 0; precision < NUM_PRECISIONS; ++precision) {
+        for (int quality = 0; quality < NUM_QUALITIES; ++quality) {
+            for (int mode : { static_cast<int>(TeeBeeFilter::TB_303), static_cast<int>(TeeBeeFilter::LP_24),
+                              static_cast<int>(TeeBeeFilter::TB_303_ZDF) }) {
+                const auto params = nullParameters(mode, quality);
+                const auto reference = render<Sample>(input, params, precision, Isa::Scalar);
+                for (int isa = 1; isa <= static_cast<int>(TeeBeeMultiChannelFilter::detectIsa()); ++isa) {
+                    const auto buffers = render<Sample>(input, params, precision, static_cast<Isa>(isa));
+                    if (std::memcmp(reference.data(), buffers.data(), buffers.size() * sizeof(Sample)) != 0) {
+                        std::printf("%s differs from scalar: %s precision, %s buffers, quality %d, mode %s\n",
+                                    TeeBeeMultiChannelFilter::getIsaName(static_cast<Isa>(isa)), precisionNames[precision],
+                                    sizeof(Sample) == sizeof(float) ? "float" : "double", quality, modeNames[mode]);
+                        check(false, "SIMD/scalar bit-exactness");
+                    }
+                }
+            }
+        }
+    }
+}
+
+void testDoubleBuffers(const std::vector<float>& input)
+{
+    for (int mode = 0; mode < TeeBeeFilter::NUM_MODES; ++mode) {
+        const auto params = nullParameters(mode);
+        const auto wide = render<double>(input, params, PRECISION_DOUBLE);
+        const auto narrow = render<float>(input, params, PRECISION_DOUBLE);
+
+        // Channel 0 through the scalar filter
+        TeeBeeFilter filter;
+        filter.setSampleRate(sampleRate);
+        filter.setCoefficientTable(TeeBeeCoefficientTable::forSampleRate(sampleRate).get());
+        params.applyTo(filter);
+        std::vector<double> single(input.begin(), input.end());
+        filter.processBlock(single.data(), fftSize);
+        check(std::memcmp(single.data(), wide.data(), single.size() * sizeof(double)) == 0, "double buffers match TeeBeeFilter");
+
+        bool rounded = true;
+        for (size_t i = 0; i < wide.size(); ++i) rounded = rounded && static_cast<float>(wide[i]) == narrow[i];
+        check(rounded, "double buffers round to the float-buffer output");
+    }
+}
+
+void testPrecisionSwitch(const std::vector<float>& input)
+{
+    const auto params = nullParameters(TeeBeeFilter::TB_303);
+    const auto reference = render<float>(input, params, PRECISION_DOUBLE);
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, 512);
+    engine.setParameters(params);
+    auto buffers = makeBuffers<float>(input);
+    const int third = fftSize / 3;
+    process(engine, buffers, 0, third);
+    engine.setPrecision(PRECISION_FLOAT);
+    process(engine, buffers, third, third);
+    engine.setPrecision(PRECISION_MIXED);
+    process(engine, buffers, 2 * third, fftSize - 2 * third);
+
+    const auto deviation = measureChannels(reference, buffers);
+    std::printf("switch double -> float -> mixed: residual %.1f dB\n", deviation.residualDb);
+    check(deviation.residualDb <= -90.0, "precision switch keeps the state");
+}
+} // namespace
+
+int main()
+{
+    const auto input = makeInput();
+    testPrecisionNull(input);
+    testSimdMatchesScalar<float>(input);
+    testSimdMatchesScalar<double>(input);
+    testDoubleBuffers(input);
+    testPrecisionSwitch(input);
+
+    std::printf("%s\n", failures == 0 ? "all precision checks passed" : "precision checks FAILED");
+    return failures == 0 ? 0 : 1;
+}
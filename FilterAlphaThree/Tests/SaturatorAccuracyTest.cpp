@@ -0,0 +1,122 @@
+// Accuracy of the tanh quality tiers (DSP/TeeBeeSaturators.h) against libm:
+//   1. max |Sat(x) - tanh(x)| over [-6, 6] must stay within each tier's documented maxError
+//   2. a driven TB_303 render through each tier must stay within a residual / spectral
+//      deviation budget of the exact render
+//   3. every SIMD kernel must match the scalar kernel bit for bit at every quality
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+
+constexpr double sampleRate = 48000.0;
+constexpr int fftSize = 16384;
+
+template <class Sat>
+double maxTanhError()
+{
+    double maxError = 0.0;
+    constexpr int points = 1 << 21;
+    for (int i = 0; i <= points; ++i) {
+        const double x = -6.0 + 12.0 * i / points;
+        maxError = std::max(maxError, std::abs(Sat::template apply<TeeBeeScalarOps>(x) - std::tanh(x)));
+    }
+    return maxError;
+}
+
+// Saw sweeping 55..880 Hz: covers the ladder's whole soft-clip range with drive applied
+std::vector<float> makeInput()
+{
+    std::vector<float> input(fftSize);
+    double phase = 0.0;
+    for (int i = 0; i < fftSize; ++i) {
+        const double f = 55.0 * std::pow(16.0, static_cast<double>(i) / fftSize);
+        phase += f / sampleRate;
+        phase -= std::floor(phase);
+        input[i] = static_cast<float>(0.9 * (2.0 * phase - 1.0));
+    }
+    return input;
+}
+
+template <class Sat>
+std::vector<float> render(const std::vector<float>& input)
+{
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    TeeBeeParameters params;
+    params.cutoff = 600.0;
+    params.resonance = 90.0;
+    params.drive = 30.0;
+    params.applyTo(filter);
+    auto output = input;
+    filter.processBlockWith<Sat>(output.data(), fftSize);
+    return output;
+}
+
+template <class Sat>
+void testTier(const char* name, const std::vector<float>& input, const std::vector<float>& exact, double maxDeviationDb)
+{
+    const double error = maxTanhError<Sat>();
+    const auto deviation = measure(exact, render<Sat>(input));
+    std::printf("%-6s max |error| %.3g (bound %.3g), residual %.1f dB, spectral deviation %.1f dB (limit %.0f dB)\n",
+                name, error, Sat::maxError, deviation.residualDb, deviation.spectralDb, maxDeviationDb);
+    check(error <= Sat::maxError, name);
+    check(deviation.residualDb <= maxDeviationDb && deviation.spectralDb <= maxDeviationDb, name);
+}
+
+void testSimdMatchesScalar(const std::vector<float>& input)
+{
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    constexpr int numChannels = 8;
+    for (int quality = 0; quality < NUM_QUALITIES; ++quality) {
+        std::vector<float> reference;
+        for (int isa = 0; isa <= static_cast<int>(TeeBeeMultiChannelFilter::detectIsa()); ++isa) {
+            TeeBeeMultiChannelFilter engine;
+            engine.setMaxIsa(static_cast<Isa>(isa));
+            engine.prepare(numChannels, sampleRate, 512);
+            TeeBeeParameters params;
+            params.drive = 30.0;
+            params.resonance = 90.0;
+            params.quality = quality;
+            engine.setParameters(params);
+
+            std::vector<float> buffers(static_cast<size_t>(numChannels) * fftSize);
+            float* channels[numChannels];
+            for (int c = 0; c < numChannels; ++c) {
+                channels[c] = buffers.data() + static_cast<size_t>(c) * fftSize;
+                for (int i = 0; i < fftSize; ++i) channels[c][i] = input[i] * (1.0f - 0.1f * c);
+            }
+            engine.process(channels, numChannels, fftSize);
+
+            if (isa == 0)
+                reference = buffers;
+            else if (std::memcmp(reference.data(), buffers.data(), buffers.size() * sizeof(float)) != 0) {
+                std::printf("%s differs from scalar at quality %d\n", TeeBeeMultiChannelFilter::getIsaName(static_cast<Isa>(isa)), quality);
+                check(false, "SIMD/scalar bit-exactness");
+            }
+        }
+    }
+}
+} // namespace
+
+int main()
+{
+    const auto input = makeInput();
+    const auto exact = render<TeeBeeTanhExact>(input);
+
+    testTier<TeeBeeTanhExact>("exact", input, exact, -300.0);
+    testTier<TeeBeeTanhTable>("table", input, exact, -120.0);
+    testTier<TeeBeeTanhPade>("pade", input, exact, -90.0);
+    testSimdMatchesScalar(input);
+
+    std::printf("%s\n", failures == 0 ? "all saturator checks passed" : "saturator checks FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Tests of the binary state and preset bank formats (TeeBeeState.h):
+//   1. a state round-trips bit for bit and is teeBeeStateSize bytes
+//   2. unknown parameters are skipped, missing ones keep their value, non-finite values are
+//      ignored, and truncated or foreign data (the XML of earlier builds) is rejected untouched
+//   3. a bank round-trips names and values, can be read in place at any offset, maps columns
+//      written in a different order, and rejects a header that claims more presets than it holds
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeState.h"
+#include "TestSupport.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+
+void makeValues(float* values, float offset)
+{
+    for (int i = 0; i < NUM_PARAMETERS; ++i) values[i] = teeBeeParameterDefaults[i] + offset * static_cast<float>(i + 1);
+}
+
+void putU32(unsigned char* p, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void testStateRoundTrip()
+{
+    float values[NUM_PARAMETERS], decoded[NUM_PARAMETERS] {};
+    makeValues(values, 0.37f);
+    unsigned char state[teeBeeStateSize];
+    teeBeeEncodeState(values, state);
+    check(teeBeeDecodeState(state, sizeof(state), decoded), "state decodes");
+    check(std::memcmp(values, decoded, sizeof(values)) == 0, "state round-trips bit for bit");
+    std::printf("state: %zu bytes\n", sizeof(state));
+}
+
+void testStateCompatibility()
+{
+    float values[NUM_PARAMETERS], decoded[NUM_PARAMETERS];
+    makeValues(values, 1.0f);
+    unsigned char state[teeBeeStateSize];
+    teeBeeEncodeState(values, state);
+
+    // A newer build's parameter in place of "drive", and a NaN resonance
+    putU32(state + 8 + 8 * PARAM_DRIVE, teeBeeParameterHash("future"));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::uint32_t bits;
+    std::memcpy(&bits, &nan, 4);
+    putU32(state + 12 + 8 * PARAM_RESONANCE, bits);
+    makeValues(decoded, 0.0f);
+    check(teeBeeDecodeState(state, sizeof(state), decoded), "state with unknown parameters decodes");
+    check(decoded[PARAM_DRIVE] == teeBeeParameterDefaults[PARAM_DRIVE], "unknown parameter skipped");
+    check(decoded[PARAM_RESONANCE] == teeBeeParameterDefaults[PARAM_RESONANCE], "non-finite value ignored");
+    check(decoded[PARAM_CUTOFF] == values[PARAM_CUTOFF] && decoded[PARAM_PRECISION] == values[PARAM_PRECISION],
+          "known parameters read");
+
+    // An older build that only knew the first three parameters
+    unsigned char older[8 + 8 * 3];
+    teeBeeEncodeState(values, state);
+    std::memcpy(older, state, sizeof(older));
+    older[6] = 3;
+    makeValues(decoded, 0.0f);
+    check(teeBeeDecodeState(older, sizeof(older), decoded), "older state decodes");
+    check(decoded[PARAM_DRIVE] == values[PARAM_DRIVE] && decoded[PARAM_MODE] == teeBeeParameterDefaults[PARAM_MODE],
+          "missing parameters keep their value");
+
+    makeValues(decoded, 0.0f);
+    check(!teeBeeDecodeState(state, sizeof(state) - 1, decoded), "truncated state rejected");
+    const char xml[] = "VC2!\x10\0\0\0<?xml version=\"1.0\"?><PARAMS/>";
+    check(!teeBeeDecodeState(xml, sizeof(xml), decoded), "XML state rejected");
+    check(decoded[PARAM_CUTOFF] == teeBeeParameterDefaults[PARAM_CUTOFF], "rejected state leaves the values alone");
+}
+
+void testBank()
+{
+    std::vector<TeeBeePreset> presets(1000);
+    for (size_t p = 0; p < presets.size(); ++p) {
+        presets[p].name = "Preset " + std::to_string(p);
+        makeValues(presets[p].values, static_cast<float>(p) * 0.01f);
+    }
+    presets[7].name = "A name far longer than the thirty-one bytes a record holds";
+    const auto bytes = teeBeeWritePresetBank(presets);
+
+    // Read in place from an odd offset, as from a mapped file with no alignment guarantee
+    std::vector<unsigned char> mapped(bytes.size() + 1);
+    std::memcpy(mapped.data() + 1, bytes.data(), bytes.size());
+    TeeBeePresetBank bank;
+    check(bank.open(mapped.data() + 1, bytes.size()), "bank opens");
+    check(bank.getNumPresets() == 1000, "bank preset count");
+    bool valuesMatch = true;
+    for (int p = 0; p < bank.getNumPresets(); ++p) {
+        float values[NUM_PARAMETERS] {};
+        valuesMatch = valuesMatch && bank.getValues(p, values)
+                   && std::memcmp(values, presets[static_cast<size_t>(p)].values, sizeof(values)) == 0;
+    }
+    check(valuesMatch, "bank values round-trip");
+    check(bank.getName(999) == "Preset 999" && bank.findPreset("Preset 512") == 512, "bank names");
+    check(bank.getName(7).size() == teeBeePresetNameSize - 1, "long name cut");
+    check(bank.getName(1000).empty() && !bank.getValues(-1, presets[0].values), "out-of-range preset");
+    std::printf("bank: %d presets, %zu bytes\n", bank.getNumPresets(), bytes.size());
+
+    // Columns in another order: swap the hashes of cutoff and precision, their values follow
+    auto swapped = bytes;
+    putU32(swapped.data() + 20 + 4 * PARAM_CUTOFF, teeBeeParameterHash("precision"));
+    putU32(swapped.data() + 20 + 4 * PARAM_PRECISION, teeBeeParameterHash("cutoff"));
+    check(bank.open(swapped.data(), swapped.size()), "reordered bank opens");
+    float values[NUM_PARAMETERS] {};
+    bank.getValues(3, values);
+    check(values[PARAM_PRECISION] == presets[3].values[PARAM_CUTOFF] && values[PARAM_CUTOFF] == presets[3].values[PARAM_PRECISION],
+          "reordered columns mapped by hash");
+
+    check(!bank.open(bytes.data(), bytes.size() - 1) && bank.getNumPresets() == 0, "truncated bank rejected");
+}
+} // namespace
+
+int main()
+{
+    testStateRoundTrip();
+    testStateCompatibility();
+    testBank();
+    if (failures == 0) std::printf("all state format tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#ifndef TEEBEE_TEST_SUPPORT_H_INCLUDED
+#define TEEBEE_TEST_SUPPORT_H_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+#include "TeeBeeFilter.h"
+
+/**
+ * Helpers shared by the DSP tests in Tests/, each of which is one ctest executable
+ * - check() prints a failed condition and counts it in `failures`; main() returns non-zero then
+ * - measure() compares a render with its reference: residual energy, largest spectral difference
+ *   (Hann-windowed FFT, power-of-two lengths) and largest sample difference, all in dB
+ * - Random is the fixed-seed LCG every stimulus draws its noise from, so a failure reproduces
+ * - makeParameters()/makeFilter() set up a TeeBeeFilter the way the plug-in does (applyTo)
+ */
+namespace TeeBeeTest
+{
+inline int failures = 0;
+
+// TeeBeeFilter::Mode order
+inline constexpr const char* modeNames[] = { "tb303", "lp24", "lp18", "lp12", "hp12", "flat", "tb303zdf" };
+static_assert(std::size(modeNames) == TeeBeeFilter::NUM_MODES);
+
+inline void check(bool ok, const char* what)
+{
+    if (!ok) {
+        std::printf("FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+// Numerical Recipes LCG; the draws use its top 24 bits
+struct Random
+{
+    std::uint32_t state;
+    explicit Random(std::uint32_t seed) : state(seed) {}
+    std::uint32_t next() { return state = state * 1664525u + 1013904223u; }
+    double uniform() { return static_cast<double>(next() >> 8) / (1 << 24); } // [0, 1)
+    double bipolar() { return 2.0 * uniform() - 1.0; }                        // [-1, 1)
+    int below(int n) { return static_cast<int>((next() >> 8) % static_cast<std::uint32_t>(n)); }
+};
+
+inline TeeBeeParameters makeParameters(int mode, double cutoff, double resonance, double drive,
+                                       int quality = QUALITY_EXACT)
+{
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.quality = quality;
+    params.cutoff = cutoff;
+    params.resonance = resonance;
+    params.drive = drive;
+    return params;
+}
+
+// At rest, with `table` (if any) in place before the coefficients are computed
+inline TeeBeeFilter makeFilter(const TeeBeeParameters& params, double sampleRate,
+                               const TeeBeeCoefficientTable* table = nullptr)
+{
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    if (table != nullptr) filter.setCoefficientTable(table);
+    params.applyTo(filter);
+    filter.reset();
+    return filter;
+}
+
+// In place, radix 2; x.size() must be a power of two
+inline void fft(std::vector<std::complex<double>>& x)
+{
+    const size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const std::complex<double> w = std::polar(1.0, -2.0 * TeeBeeFilter::pi / static_cast<double>(len));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> wk = 1.0;
+            for (size_t k = 0; k < len / 2; ++k, wk *= w) {
+                const auto a = x[i + k], b = x[i + k + len / 2] * wk;
+                x[i + k] = a + b;
+                x[i + k + len / 2] = a - b;
+            }
+        }
+    }
+}
+
+// Hann-windowed spectrum of n samples
+template <class Sample>
+std::vector<std::complex<double>> spectrum(const Sample* signal, size_t n)
+{
+    std::vector<std::complex<double>> x(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double hann = 0.5 - 0.5 * std::cos(2.0 * TeeBeeFilter::pi * static_cast<double>(i) / static_cast<double>(n));
+        x[i] = hann * static_cast<double>(signal[i]);
+    }
+    fft(x);
+    return x;
+}
+
+inline double toDb(double ratio) { return 20.0 * std::log10(std::max(ratio, 1e-30)); }
+
+struct Deviation { double residualDb, spectralDb, peakDb; };
+
+// Residual energy relative to the reference, the largest per-bin spectral difference relative to
+// the reference's strongest bin, and the largest sample difference (dB re 1.0)
+template <class Sample>
+Deviation measure(const Sample* reference, const Sample* test, size_t n)
+{
+    double signal = 0.0, residual = 0.0, peak = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double d = static_cast<double>(test[i]) - static_cast<double>(reference[i]);
+        signal += static_cast<double>(reference[i]) * static_cast<double>(reference[i]);
+        residual += d * d;
+        peak = std::max(peak, std::abs(d));
+    }
+    const auto a = spectrum(reference, n), b = spectrum(test, n);
+    double peakBin = 0.0, maxDiff = 0.0;
+    for (size_t k = 0; k <= n / 2; ++k) {
+        peakBin = std::max(peakBin, std::abs(a[k]));
+        maxDiff = std::max(maxDiff, std::abs(a[k] - b[k]));
+    }
+    return { toDb(std::sqrt(residual / signal)), toDb(maxDiff / peakBin), toDb(peak) };
+}
+
+template <class Sample>
+Deviation measure(const std::vector<Sample>& reference, const std::vector<Sample>& test)
+{
+    return measure(reference.data(), test.data(), reference.size());
+}
+} // namespace TeeBeeTest
+
+#endif // TEEBEE_TEST_SUPPORT_H_INCLUDED
@@ -0,0 +1,272 @@
+// Tests of the zero-delay-feedback diode ladder (TeeBeeFilter::TB_303_ZDF):
+//   1. the resonant peak sits on the cutoff, and at the same frequency at 44.1, 48, 96 and 192 kHz
+//   2. the kernel's capped Newton solve matches a reference solved to convergence, under drive
+//   3. at full resonance it self-oscillates at the cutoff, and no input makes it blow up
+//   4. a mode switch to or from it after a glide matches a filter set up for the new mode
+// Exits non-zero on failure; registered with ctest.
+
+#include "TeeBeeFilter.h"
+#include "TestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace TeeBeeTest;
+
+constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+
+TeeBeeFilter zdfFilter(int mode, double sampleRate, double cutoff, double resonance, double drive, double fbAmp = 50.0)
+{
+    auto params = makeParameters(mode, cutoff, resonance, drive);
+    params.fbHp = 20.0; // Out of the way of the peak
+    params.fbAmp = fbAmp;
+    return makeFilter(params, sampleRate);
+}
+
+// Frequency of the strongest bin above 40 Hz, refined by a parabola through the log magnitudes
+double peakFrequency(const std::vector<double>& signal, double sampleRate, bool window)
+{
+    std::vector<std::complex<double>> x(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i) {
+        const double hann = 0.5 - 0.5 * std::cos(2.0 * TeeBeeFilter::pi * static_cast<double>(i) / signal.size());
+        x[i] = (window ? hann : 1.0) * signal[i];
+    }
+    fft(x);
+    const double binWidth = sampleRate / static_cast<double>(x.size());
+    size_t best = static_cast<size_t>(40.0 / binWidth) + 1;
+    for (size_t k = best; k + 1 < x.size() / 2; ++k)
+        if (std::abs(x[k]) > std::abs(x[best])) best = k;
+    const double a = std::log(std::abs(x[best - 1])), b = std::log(std::abs(x[best])), c = std::log(std::abs(x[best + 1]));
+    return (static_cast<double>(best) + 0.5 * (a - c) / (a - 2.0 * b + c)) * binWidth;
+}
+
+// Small-signal impulse response, zero-padded to 2^18 points at 192 kHz (under 1 Hz per bin)
+double responsePeak(double sampleRate, double cutoff)
+{
+    auto filter = zdfFilter(TeeBeeFilter::TB_303_ZDF, sampleRate, cutoff, 90.0, 0.0);
+    std::vector<double> response(static_cast<size_t>(1) << (sampleRate > 100000.0 ? 18 : 16), 0.0);
+    response[0] = 1e-3;
+    filter.processBlock(response.data(), static_cast<int>(response.size()));
+    return peakFrequency(response, sampleRate, false);
+}
+
+double cents(double f, double reference) { return 1200.0 * std::log2(f / reference); }
+
+void testPeakAtCutoff()
+{
+    for (const double cutoff : { 250.0, 1000.0, 4000.0, 12000.0 }) {
+        double lowest = 1e9, highest = 0.0;
+        for (const double sampleRate : sampleRates) {
+            const double peak = responsePeak(sampleRate, cutoff);
+            lowest = std::min(lowest, peak);
+            highest = std::max(highest, peak);
+            std::printf("cutoff %5.0f Hz @ %6.0f Hz: peak %8.1f Hz (%+5.1f cents)\n", cutoff, sampleRate, peak, cents(peak, cutoff));
+            check(std::abs(cents(peak, cutoff)) < 30.0, "resonant peak at the cutoff");
+        }
+        std::printf("cutoff %5.0f Hz: peak moves %.1f cents across sample rates\n", cutoff, cents(highest, lowest));
+        check(cents(highest, lowest) < 5.0, "resonant peak independent of the sample rate");
+    }
+}
+
+// The ladder solved to convergence in double: same staging as the kernel, Newton's method on the
+// full implicit equations until the step stops shrinking
+struct ReferenceLadder
+{
+    double g, k, hpScale, inputGain, dcPole = 0.9995;
+    double s[4] = {}, sHp = 0.0, dcX1 = 0.0, dcY1 = 0.0;
+    int maxIterations = 0;
+
+    double process(double in)
+    {
+        const double c = k * hpScale;
+        const double x = teeBeeZdfLevel * std::clamp(inputGain * in, -2.0, 2.0) + 1e-12;
+        const double u0 = x + c * sHp;
+        double y[4] = { s[0], s[1], s[2], s[3] };
+        int iterations = 0;
+        for (double lastStep = 1e300; iterations < 100; ++iterations) {
+            const double t0 = std::tanh(std::clamp(u0 - c * y[3] - y[0], -6.0, 6.0)), t1 = std::tanh(std::clamp(y[0] - y[1], -6.0, 6.0));
+            const double t2 = std::tanh(std::clamp(y[1] - y[2], -6.0, 6.0)), t3 = std::tanh(std::clamp(y[2] - y[3], -6.0, 6.0));
+            const double f[4] = { y[0] - s[0] - g * (t0 - t1), y[1] - s[1] - g * (t1 - t2), y[2] - s[2] - g * (t2 - t3),
+                                  y[3] - s[3] - 2.0 * g * t3 };
+            const double d0 = 1.0 - t0 * t0, d1 = 1.0 - t1 * t1, d2 = 1.0 - t2 * t2, d3 = 1.0 - t3 * t3;
+            // Dense Jacobian, Gaussian elimination with partial pivoting
+            double j[4][5] = { { 1.0 + g * (d0 + d1), -g * d1, 0.0, g * d0 * c, -f[0] },
+                               { -g * d1, 1.0 + g * (d1 + d2), -g * d2, 0.0, -f[1] },
+                               { 0.0, -g * d2, 1.0 + g * (d2 + d3), -g * d3, -f[2] },
+                               { 0.0, 0.0, -2.0 * g * d3, 1.0 + 2.0 * g * d3, -f[3] } };
+            for (int col = 0; col < 4; ++col) {
+                int pivot = col;
+                for (int row = col + 1; row < 4; ++row)
+                    if (std::abs(j[row][col]) > std::abs(j[pivot][col])) pivot = row;
+                std::swap(j[col], j[pivot]);
+                for (int row = col + 1; row < 4; ++row) {
+                    const double m = j[row][col] / j[col][col];
+                    for (int k2 = col; k2 < 5; ++k2) j[row][k2] -= m * j[col][k2];
+                }
+            }
+            double d[4], step = 0.0;
+            for (int row = 3; row >= 0; --row) {
+                double sum = j[row][4];
+                for (int k2 = row + 1; k2 < 4; ++k2) sum -= j[row][k2] * d[k2];
+                d[row] = sum / j[row][row];
+                step = std::max(step, std::abs(d[row]));
+            }
+            for (int i = 0; i < 4; ++i) y[i] += d[i];
+            if (step == 0.0 || step >= lastStep) break;
+            lastStep = step;
+        }
+        maxIterations = std::max(maxIterations, iterations);
+        for (int i = 0; i < 4; ++i) s[i] = 2.0 * y[i] - s[i];
+        const double lp = y[3] - (y[3] - sHp) * hpScale;
+        sHp = 2.0 * lp - sHp;
+
+        const double out = std::clamp(std::tanh(std::clamp(y[3] / teeBeeZdfLevel * 0.8, -6.0, 6.0)) * 1.25, -2.0, 2.0);
+        const double dc = out - dcX1 + dcPole * dcY1;
+        dcX1 = out;
+        dcY1 = dc;
+        return dc;
+    }
+};
+
+void testAgainstConvergedSolve()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int numSamples = 44100;
+    for (const double drive : { 0.0, 24.0, 48.0 }) {
+        for (const double resonance : { 50.0, 95.0 }) {
+            auto filter = zdfFilter(TeeBeeFilter::TB_303_ZDF, sampleRate, 800.0, resonance, drive);
+            const double x = std::exp(-2.0 * TeeBeeFilter::pi * 20.0 / sampleRate);
+            ReferenceLadder reference { std::tan(TeeBeeFilter::pi * 800.0 / sampleRate) / teeBeeZdfPeakRatio,
+                                        2.0 * teeBeeZdfCriticalGain * (1.0 - (1.0 - resonance * 0.01) * (1.0 - resonance * 0.01)) * 0.5, // 50% feedback
+                                        0.5 * (1.0 + x), 0.125 * std::pow(10.0, drive * 0.05) * 0.25 };
+
+            // A loud 55 Hz saw, the acid bass line case
+            std::vector<double> output(numSamples), expected(numSamples);
+            double phase = 0.0;
+            for (int i = 0; i < numSamples; ++i) {
+                phase += 55.0 / sampleRate;
+                phase -= std::floor(phase);
+                output[i] = 0.9 * (2.0 * phase - 1.0);
+                expected[i] = reference.process(output[i]);
+            }
+            filter.processBlock(output.data(), numSamples);
+
+            double signal = 0.0, residual = 0.0;
+            for (int i = 0; i < numSamples; ++i) {
+                signal += expected[i] * expected[i];
+                residual += (output[i] - expected[i]) * (output[i] - expected[i]);
+            }
+            const double residualDb = 10.0 * std::log10(std::max(residual, 1e-300) / signal);
+            std::printf("drive %2.0f dB, resonance %2.0f%%: %d Newton steps vs converged (up to %d): residual %.1f dB\n", drive,
+                        resonance, teeBeeZdfNewtonIterations, reference.maxIterations, residualDb);
+            check(residualDb < -90.0, "capped Newton solve matches the converged solve");
+        }
+    }
+}
+
+// Level and pitch of what is left a second after a kick into a ladder at full resonance
+struct Ringing { double level, frequency; };
+
+Ringing ringAfterKick(double sampleRate, double fbAmp)
+{
+    auto filter = zdfFilter(TeeBeeFilter::TB_303_ZDF, sampleRate, 1000.0, 100.0, 0.0, fbAmp);
+    std::vector<double> output(static_cast<size_t>(sampleRate), 0.0);
+    output[0] = 1.0;
+    filter.processBlock(output.data(), static_cast<int>(output.size()));
+    const std::vector<double> tail(output.end() - 16384, output.end());
+    double level = 0.0;
+    for (double v : tail) level = std::max(level, std::abs(v));
+    return { level, peakFrequency(tail, sampleRate, true) };
+}
+
+// Past the critical loop gain (full resonance, more than 50% feedback) the ladder holds a tone
+// near the cutoff; the saturating first stage pulls it a little flat, by the same amount at any
+// sample rate. Below it, the ringing dies away
+void testSelfOscillation()
+{
+    const Ringing low = ringAfterKick(44100.0, 55.0), high = ringAfterKick(96000.0, 55.0);
+    for (const auto& [sampleRate, ringing] : { std::pair { 44100.0, low }, std::pair { 96000.0, high } }) {
+        std::printf("self-oscillation @ %6.0f Hz: %.1f Hz (%+.1f cents from the cutoff), level %.4f\n", sampleRate,
+                    ringing.frequency, cents(ringing.frequency, 1000.0), ringing.level);
+        check(ringing.level > 1e-3, "self-oscillates past the critical gain");
+        check(std::abs(cents(ringing.frequency, 1000.0)) < 100.0, "self-oscillation near the cutoff");
+    }
+    check(std::abs(cents(high.frequency, low.frequency)) < 2.0, "self-oscillation pitch independent of the sample rate");
+    check(ringAfterKick(44100.0, 45.0).level < 1e-6, "below the critical gain the ringing dies away");
+}
+
+void testBounded()
+{
+    const double inputs[] = { 1e6, -1e6, 1.0, std::numeric_limits<double>::quiet_NaN(), 0.0 };
+    for (const double drive : { 0.0, 60.0 }) {
+        for (const double fbAmp : { 50.0, 100.0 }) {
+            auto filter = zdfFilter(TeeBeeFilter::TB_303_ZDF, 44100.0, 20000.0, 100.0, drive, fbAmp);
+            std::vector<double> output(44100);
+            Random random(3);
+            for (size_t i = 0; i < output.size(); ++i)
+                output[i] = i < 4000 ? inputs[(i / 800) % 5] : 2.0 * random.bipolar();
+            filter.processBlock(output.data(), static_cast<int>(output.size()));
+            bool bounded = true;
+            for (double v : output) bounded = bounded && std::isfinite(v) && std::abs(v) <= 4.0;
+            check(bounded, "bounded and finite under extreme input and feedback");
+        }
+    }
+}
+// A glide leaves only the running kernel's cutoff terms at their target: a switch to or from the
+// zero-delay ladder afterwards must come out as a filter set up for the new mode from scratch
+void testModeSwitchAfterRamp()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int rampLength = 2048, numSamples = 4096;
+    std::vector<double> saw(numSamples);
+    for (int i = 0; i < numSamples; ++i) saw[i] = 0.9 * (2.0 * std::fmod(110.0 * i / sampleRate, 1.0) - 1.0);
+
+    const std::pair<int, int> switches[] = { { TeeBeeFilter::TB_303, TeeBeeFilter::TB_303_ZDF },
+                                             { TeeBeeFilter::LP_24, TeeBeeFilter::TB_303_ZDF },
+                                             { TeeBeeFilter::TB_303_ZDF, TeeBeeFilter::TB_303 },
+                                             { TeeBeeFilter::TB_303_ZDF, TeeBeeFilter::HP_12 } };
+    for (const auto& [from, to] : switches) {
+        auto ramped = zdfFilter(from, sampleRate, 300.0, 80.0, 6.0);
+        TeeBeeParameters target;
+        target.mode = from;
+        target.cutoff = 2500.0;
+        target.resonance = 80.0;
+        target.drive = 6.0;
+        target.fbHp = 20.0;
+        target.rampTo(ramped, rampLength);
+        std::vector<double> output(saw);
+        ramped.processBlock(output.data(), numSamples); // The glide, then settled
+        ramped.setMode(to);
+        ramped.reset();
+
+        target.mode = to;
+        auto fresh = zdfFilter(to, sampleRate, target.cutoff, target.resonance, target.drive);
+        std::vector<double> expected(saw);
+        output = saw;
+        ramped.processBlock(output.data(), numSamples);
+        fresh.processBlock(expected.data(), numSamples);
+        double difference = 0.0;
+        for (int i = 0; i < numSamples; ++i) difference = std::max(difference, std::abs(output[i] - expected[i]));
+        std::printf("glide in %s, then %s: %.2g from a freshly set filter\n", modeNames[from], modeNames[to], difference);
+        check(difference < 1e-9, "mode switch after a glide matches a freshly set filter");
+    }
+}
+} // namespace
+
+int main()
+{
+    testPeakAtCutoff();
+    testAgainstConvergedSolve();
+    testSelfOscillation();
+    testBounded();
+    testModeSwitchAfterRamp();
+    if (failures == 0) std::printf("all zero-delay ladder tests passed\n");
+    return failures == 0 ? 0 : 1;
+}
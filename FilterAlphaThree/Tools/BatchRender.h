@@ -0,0 +1,346 @@
+#pragma once
+#ifndef TEEBEE_BATCH_RENDER_H_INCLUDED
+#define TEEBEE_BATCH_RENDER_H_INCLUDED
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Batch rendering for filteralpha-batch: many WAV files, each with its own settings and
+ * automation, rendered on a pool of worker threads.
+ * - A job is one file, rendered start to end by one worker in fixed-size chunks, so memory
+ *   stays at a few chunks per worker however long the files are
+ * - Jobs are dealt out largest first; a worker whose queue runs dry steals from the back of
+ *   another's (the smallest jobs left), so long files do not leave cores idle at the end
+ * - A job's output depends only on the job and the chunk size, never on the thread count or
+ *   on which worker ran it: every job gets a fresh engine
+ * - Automation curves glide each parameter linearly between its points, sample-accurately
+ *   (TeeBeeMultiChannelFilter::processAutomated)
+ */
+namespace BatchRender
+{
+// How the filter is set up for a whole file, as the plug-in's parameters (a preset) give it
+struct Settings
+{
+    TeeBeeParameters params;
+    int oversampling = 1;
+    TeeBeeOversampler::Phase phase = TeeBeeOversampler::Phase::Minimum;
+    int precision = PRECISION_DOUBLE;
+};
+
+// Plain parameter values (TeeBeeParameterIndex order, as presets store them) to settings
+inline Settings settingsFromValues(const float* values)
+{
+    Settings settings;
+    auto& params = settings.params;
+    params.cutoff = values[PARAM_CUTOFF];
+    params.resonance = values[PARAM_RESONANCE];
+    params.drive = values[PARAM_DRIVE];
+    params.fbHp = values[PARAM_FB_HP];
+    params.fbAmp = values[PARAM_FB_AMP];
+    params.mode = std::clamp(static_cast<int>(values[PARAM_MODE]), 0, TeeBeeFilter::NUM_MODES - 1);
+    params.quality = std::clamp(static_cast<int>(values[PARAM_QUALITY]), 0, NUM_QUALITIES - 1);
+    settings.oversampling = 1 << std::clamp(static_cast<int>(values[PARAM_OVERSAMPLING]), 0, 3);
+    settings.phase = values[PARAM_OS_PHASE] > 0.5f ? TeeBeeOversampler::Phase::Linear : TeeBeeOversampler::Phase::Minimum;
+    settings.precision = std::clamp(static_cast<int>(values[PARAM_PRECISION]), 0, NUM_PRECISIONS - 1);
+    return settings;
+}
+
+// Automation
+// The automatable parameters are cutoff, resonance, drive, mode, fbhp and fbamp: indices 0..5
+constexpr int numAutomatable = PARAM_FB_AMP + 1;
+
+struct CurvePoint
+{
+    double time = 0.0; // Seconds from the start of the file
+    int parameter = 0; // PARAM_CUTOFF .. PARAM_FB_AMP
+    double value = 0.0;
+};
+
+// An automation curve file: one "time,parameter,value" row per point (seconds, parameter ID,
+// plain value; mode by index), in any order. '#' starts a comment; a header row is skipped
+inline bool loadCurve(const std::string& path, std::vector<CurvePoint>& points, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file) { error = "cannot open " + path; return false; }
+    points.clear();
+    std::string line;
+    for (int row = 1; std::getline(file, line); ++row) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        std::stringstream stream(line);
+        std::string fields[3];
+        for (auto& field : fields) {
+            std::getline(stream, field, ',');
+            const auto first = field.find_first_not_of(" \t\r"), last = field.find_last_not_of(" \t\r");
+            field = first == std::string::npos ? std::string() : field.substr(first, last - first + 1);
+        }
+        char* end = nullptr;
+        CurvePoint point;
+        point.time = std::strtod(fields[0].c_str(), &end);
+        if (fields[0].empty() || *end != '\0') {
+            if (points.empty() && row == 1) continue; // Header
+            error = path + ":" + std::to_string(row) + ": bad time";
+            return false;
+        }
+        point.parameter = teeBeeParameterIndex(teeBeeParameterHash(fields[1]));
+        if (point.parameter < 0 || point.parameter >= numAutomatable) {
+            error = path + ":" + std::to_string(row) + ": '" + fields[1] + "' cannot be automated";
+            return false;
+        }
+        point.value = std::strtod(fields[2].c_str(), &end);
+        if (fields[2].empty() || *end != '\0' || !std::isfinite(point.value) || point.time < 0.0) {
+            error = path + ":" + std::to_string(row) + ": bad value";
+            return false;
+        }
+        points.push_back(point);
+    }
+    std::stable_sort(points.begin(), points.end(), [](const auto& a, const auto& b) { return a.time < b.time; });
+    return true;
+}
+
+// A curve at one sample rate: each parameter starts at its first point's value, glides linearly
+// from point to point (mode steps) and holds its last value
+class CurvePlayer
+{
+public:
+    CurvePlayer(const std::vector<CurvePoint>& points, double sampleRate)
+    {
+        for (const auto& point : points)
+            tracks[point.parameter].push_back({ std::llround(point.time * sampleRate), point.value });
+    }
+
+    // `params` with every automated parameter at its value at sample 0
+    void applyStart(TeeBeeParameters& params) const
+    {
+        for (int parameter = 0; parameter < numAutomatable; ++parameter) {
+            if (tracks[parameter].empty()) continue;
+            if (parameter == PARAM_MODE) params.mode = std::clamp(static_cast<int>(valueAt(parameter, 0)), 0, TeeBeeFilter::NUM_MODES - 1);
+            else *teeBeeContinuousParameter(params, parameter) = valueAt(parameter, 0);
+        }
+    }
+
+    // The points for samples [start, start + numSamples), sorted by offset: the points inside, and
+    // where a parameter is gliding, its value at the end so the glide carries on into the next chunk
+    void getEvents(std::int64_t start, int numSamples, std::vector<TeeBeeParameterEvent>& events) const
+    {
+        events.clear();
+        const std::int64_t end = start + numSamples;
+        for (int parameter = 0; parameter < numAutomatable; ++parameter) {
+            const auto& track = tracks[parameter];
+            if (track.empty()) continue;
+            const bool isMode = parameter == PARAM_MODE;
+            bool inside = false;
+            for (auto point = firstAfter(track, start - (isMode ? 1 : 0)); point != track.end() && point->sample < end; ++point) {
+                events.push_back({ static_cast<int>(point->sample - start), parameter, point->value });
+                inside = true;
+            }
+            if (!isMode && (inside || valueAt(parameter, end) != valueAt(parameter, start)))
+                events.push_back({ numSamples, parameter, valueAt(parameter, end) });
+        }
+        std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+    }
+
+    bool isEmpty() const
+    {
+        return std::all_of(std::begin(tracks), std::end(tracks), [](const auto& track) { return track.empty(); });
+    }
+
+private:
+    struct TrackPoint
+    {
+        std::int64_t sample;
+        double value;
+    };
+    using Track = std::vector<TrackPoint>;
+
+    static Track::const_iterator firstAfter(const Track& track, std::int64_t sample)
+    {
+        return std::upper_bound(track.begin(), track.end(), sample, [](std::int64_t s, const TrackPoint& p) { return s < p.sample; });
+    }
+
+    double valueAt(int parameter, std::int64_t sample) const
+    {
+        const auto& track = tracks[parameter];
+        const auto after = firstAfter(track, sample);
+        if (after == track.begin()) return track.front().value;
+        const auto before = after - 1;
+        if (after == track.end() || parameter == PARAM_MODE) return before->value;
+        return before->value + (after->value - before->value) * static_cast<double>(sample - before->sample)
+                                   / static_cast<double>(after->sample - before->sample);
+    }
+
+    Track tracks[numAutomatable];
+};
+
+// Rendering
+struct Job
+{
+    std::string input, output;
+    Settings settings;
+    const std::vector<CurvePoint>* curve = nullptr; // Shared between jobs, read-only; nullptr for none
+};
+
+struct Options
+{
+    int bits = 32;         // Output format: 16, 24 or 32 (float)
+    int blockSize = 65536; // Chunk size; outputs are identical for the same chunk size
+    TeeBeeMultiChannelFilter::Isa maxIsa = TeeBeeMultiChannelFilter::Isa::AVX512;
+};
+
+struct Result
+{
+    bool ok = false;
+    std::string error;
+    std::uint64_t frames = 0;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+};
+
+// One worker's chunk buffers, reused from job to job
+struct Buffers
+{
+    std::vector<float> interleaved;
+    std::vector<std::vector<float>> channelData;
+    std::vector<float*> channels;
+    std::vector<TeeBeeParameterEvent> events;
+};
+
+// Relative amount of work in a job (0 if its input cannot be read), for dealing jobs out
+inline std::uint64_t estimateCost(const Job& job)
+{
+    WavFile::Reader reader;
+    std::string error;
+    if (!reader.open(job.input, error)) return 0;
+    return reader.numFrames * static_cast<std::uint64_t>(reader.numChannels) * static_cast<std::uint64_t>(job.settings.oversampling);
+}
+
+// Renders one file, streaming it chunk by chunk; the same steps as filteralpha-render, so a job
+// without a curve matches its output bit for bit
+inline Result renderJob(const Job& job, const Options& options, Buffers& buffers)
+{
+    Result result;
+    WavFile::Reader reader;
+    if (!reader.open(job.input, result.error)) return result;
+    WavFile::Writer writer;
+    if (!writer.open(job.output, reader.numChannels, reader.sampleRate, options.bits, result.error)) return result;
+    result.numChannels = reader.numChannels;
+    result.sampleRate = reader.sampleRate;
+
+    const int numChannels = reader.numChannels, blockSize = options.blockSize;
+    const CurvePlayer curve(job.curve != nullptr ? *job.curve : std::vector<CurvePoint>(), reader.sampleRate);
+    TeeBeeParameters params = job.settings.params;
+    curve.applyStart(params);
+
+    TeeBeeMultiChannelFilter engine;
+    engine.setMaxIsa(options.maxIsa);
+    engine.prepare(numChannels, reader.sampleRate, blockSize);
+    engine.setOversampling(job.settings.oversampling, job.settings.phase);
+    engine.setPrecision(job.settings.precision);
+    engine.setParameters(params);
+    engine.reset();
+
+    buffers.interleaved.resize(static_cast<size_t>(blockSize) * static_cast<size_t>(numChannels));
+    if (buffers.channelData.size() < static_cast<size_t>(numChannels)) buffers.channelData.resize(static_cast<size_t>(numChannels));
+    buffers.channels.clear();
+    for (int ch = 0; ch < numChannels; ++ch) {
+        auto& data = buffers.channelData[static_cast<size_t>(ch)];
+        data.resize(static_cast<size_t>(blockSize));
+        buffers.channels.push_back(data.data());
+    }
+    buffers.events.clear();
+    float* interleaved = buffers.interleaved.data();
+    float* const* channels = buffers.channels.data();
+
+    // Oversampling latency: drop the first `latency` output frames and flush as many at the end
+    int latency = engine.getLatencySamples(), skip = latency;
+    std::int64_t position = 0;
+    for (int frames; (frames = reader.read(interleaved, blockSize)) > 0 || latency > 0;) {
+        if (frames <= 0) {
+            frames = std::min(latency, blockSize);
+            std::fill(interleaved, interleaved + frames * numChannels, 0.0f);
+            latency -= frames;
+        }
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < frames; ++i) channels[ch][i] = interleaved[i * numChannels + ch];
+        if (!curve.isEmpty()) curve.getEvents(position, frames, buffers.events);
+        engine.processAutomated(channels, numChannels, frames, buffers.events.data(), static_cast<int>(buffers.events.size()));
+        position += frames;
+        const int first = std::min(skip, frames);
+        skip -= first;
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = first; i < frames; ++i) interleaved[(i - first) * numChannels + ch] = channels[ch][i];
+        if (!writer.write(interleaved, frames - first)) { result.error = "write error on " + job.output; return result; }
+        result.frames += static_cast<std::uint64_t>(frames - first);
+    }
+    if (!writer.close()) { result.error = "write error on " + job.output; return result; }
+    result.ok = true;
+    return result;
+}
+
+// Work-stealing pool for a fixed set of jobs: calls task(job, worker) once for every job index,
+// on numThreads workers (the calling thread is worker 0). Each worker starts on its own queue,
+// dealt largest `costs` first, and takes its next job from the front; once it is empty the
+// worker steals from the back of the others'. Returns when every job has run
+inline void runJobs(const std::vector<std::uint64_t>& costs, int numThreads, const std::function<void(size_t, int)>& task)
+{
+    const size_t numJobs = costs.size();
+    numThreads = static_cast<int>(std::clamp<size_t>(static_cast<size_t>(std::max(numThreads, 1)), 1, std::max<size_t>(numJobs, 1)));
+
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<size_t> jobs;
+    };
+    std::vector<Queue> queues(static_cast<size_t>(numThreads));
+    std::vector<size_t> order(numJobs);
+    for (size_t j = 0; j < numJobs; ++j) order[j] = j;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+    for (size_t j = 0; j < numJobs; ++j) queues[j % queues.size()].jobs.push_back(order[j]);
+
+    auto work = [&](int worker) {
+        for (;;) {
+            size_t job = numJobs;
+            {
+                auto& own = queues[static_cast<size_t>(worker)];
+                std::lock_guard<std::mutex> guard(own.lock);
+                if (!own.jobs.empty()) {
+                    job = own.jobs.front();
+                    own.jobs.pop_front();
+                }
+            }
+            // Jobs never add jobs, so once every queue is empty there is nothing left to steal
+            for (int v = 1; job == numJobs && v < numThreads; ++v) {
+                auto& victim = queues[static_cast<size_t>((worker + v) % numThreads)];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.jobs.empty()) {
+                    job = victim.jobs.back();
+                    victim.jobs.pop_back();
+                }
+            }
+            if (job == numJobs) return;
+            task(job, worker);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < numThreads; ++worker) threads.emplace_back(work, worker);
+    work(0);
+    for (auto& thread : threads) thread.join();
+}
+} // namespace BatchRender
+
+#endif // TEEBEE_BATCH_RENDER_H_INCLUDED
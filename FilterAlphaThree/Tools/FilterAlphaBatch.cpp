@@ -0,0 +1,185 @@
+// filteralpha-batch: renders a list of WAV files through the TeeBeeFilter DSP core on all cores
+// (BatchRender.h). The job list has one file per row:
+//   <input.wav>,<output.wav>[,<preset>[,<automation.csv>]]
+// <preset> is a preset name from --bank (empty: the plug-in's defaults); the automation curve
+// has "time,parameter,value" rows (seconds, parameter ID, plain value). Relative paths are
+// relative to the job list; '#' starts a comment. Each output is the same whatever --threads is,
+// and a job without automation matches filteralpha-render with the preset's settings.
+
+#include "BatchRender.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void printUsage()
+{
+    std::fprintf(stderr,
+        "usage: filteralpha-batch [options] <jobs.csv>\n"
+        "  --bank <file>        presets for the jobs' preset column (filteralpha-presets build)\n"
+        "  --threads <n>        worker threads (default: one per core)\n"
+        "  --bits <16|24|32>    output format, 32 = float (default 32)\n"
+        "  --block <frames>     streaming chunk size (default 65536)\n"
+        "  --isa <name>         cap the SIMD kernel: scalar, sse2, avx2, avx512 (default: best available)\n"
+        "  --quiet              only print errors\n");
+}
+
+bool parseIsa(const char* text, TeeBeeMultiChannelFilter::Isa& isa)
+{
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    const struct { const char* name; Isa isa; } isas[] = {
+        { "scalar", Isa::Scalar }, { "sse2", Isa::SSE2 }, { "avx2", Isa::AVX2 }, { "avx512", Isa::AVX512 }
+    };
+    for (const auto& entry : isas)
+        if (std::strcmp(text, entry.name) == 0) { isa = entry.isa; return true; }
+    return false;
+}
+
+std::vector<std::string> splitCsv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    for (std::string field; std::getline(stream, field, ',');) {
+        const auto first = field.find_first_not_of(" \t\r"), last = field.find_last_not_of(" \t\r");
+        fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+    }
+    return fields;
+}
+
+// Reads the job list; curves are loaded once however many jobs share them
+bool readJobs(const std::string& path, const TeeBeePresetBank& bank, bool haveBank, std::vector<BatchRender::Job>& jobs,
+              std::map<std::string, std::unique_ptr<std::vector<BatchRender::CurvePoint>>>& curves)
+{
+    std::ifstream list(path);
+    if (!list) { std::fprintf(stderr, "cannot open %s\n", path.c_str()); return false; }
+    const std::filesystem::path base = std::filesystem::path(path).parent_path();
+    const auto resolve = [&](const std::string& file) {
+        const std::filesystem::path p(file);
+        return p.is_absolute() ? file : (base / p).string();
+    };
+
+    std::string line, error;
+    for (int row = 1; std::getline(list, line); ++row) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        const auto fields = splitCsv(line);
+        if (fields.size() < 2 || fields.size() > 4 || fields[0].empty() || fields[1].empty()) {
+            std::fprintf(stderr, "%s:%d: expected <input>,<output>[,<preset>[,<automation>]]\n", path.c_str(), row);
+            return false;
+        }
+        BatchRender::Job job;
+        job.input = resolve(fields[0]);
+        job.output = resolve(fields[1]);
+        float values[NUM_PARAMETERS];
+        std::copy(std::begin(teeBeeParameterDefaults), std::end(teeBeeParameterDefaults), values);
+        if (fields.size() > 2 && !fields[2].empty()) {
+            const int preset = haveBank ? bank.findPreset(fields[2]) : -1;
+            if (preset < 0) { std::fprintf(stderr, "%s:%d: no preset '%s'\n", path.c_str(), row, fields[2].c_str()); return false; }
+            bank.getValues(preset, values);
+        }
+        job.settings = BatchRender::settingsFromValues(values);
+        if (fields.size() > 3 && !fields[3].empty()) {
+            const std::string curvePath = resolve(fields[3]);
+            auto& curve = curves[curvePath];
+            if (curve == nullptr) {
+                curve = std::make_unique<std::vector<BatchRender::CurvePoint>>();
+                if (!BatchRender::loadCurve(curvePath, *curve, error)) { std::fprintf(stderr, "%s\n", error.c_str()); return false; }
+            }
+            job.curve = curve.get();
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BatchRender::Options options;
+    int numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    bool quiet = false;
+    std::string bankPath, jobsPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        if (arg == "--quiet") { quiet = true; continue; }
+        if (arg.rfind("--", 0) != 0) {
+            if (!jobsPath.empty()) { printUsage(); return 2; }
+            jobsPath = arg;
+            continue;
+        }
+        if (i + 1 >= argc) { std::fprintf(stderr, "missing value for %s\n", arg.c_str()); return 2; }
+        const char* value = argv[++i];
+        if (arg == "--bank") bankPath = value;
+        else if (arg == "--isa") {
+            if (!parseIsa(value, options.maxIsa)) { std::fprintf(stderr, "unknown instruction set '%s'\n", value); return 2; }
+        }
+        else if (arg == "--threads" || arg == "--bits" || arg == "--block") {
+            char* end = nullptr;
+            const long number = std::strtol(value, &end, 10);
+            if (end == value || *end != '\0' || number <= 0) { std::fprintf(stderr, "bad value for %s\n", arg.c_str()); return 2; }
+            (arg == "--threads" ? numThreads : arg == "--bits" ? options.bits : options.blockSize) = static_cast<int>(number);
+        }
+        else { std::fprintf(stderr, "unknown option %s\n", arg.c_str()); printUsage(); return 2; }
+    }
+    if (jobsPath.empty()) { printUsage(); return 2; }
+    if (options.bits != 16 && options.bits != 24 && options.bits != 32) { std::fprintf(stderr, "bits must be 16, 24 or 32\n"); return 2; }
+
+    // The bank is read once and shared by every job
+    std::vector<char> bankBytes;
+    TeeBeePresetBank bank;
+    if (!bankPath.empty()) {
+        std::ifstream file(bankPath, std::ios::binary);
+        if (!file) { std::fprintf(stderr, "cannot open %s\n", bankPath.c_str()); return 1; }
+        bankBytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (!bank.open(bankBytes.data(), bankBytes.size())) { std::fprintf(stderr, "%s is not a preset bank\n", bankPath.c_str()); return 1; }
+    }
+    std::vector<BatchRender::Job> jobs;
+    std::map<std::string, std::unique_ptr<std::vector<BatchRender::CurvePoint>>> curves;
+    if (!readJobs(jobsPath, bank, !bankPath.empty(), jobs, curves)) return 2;
+
+    std::vector<std::uint64_t> costs;
+    for (const auto& job : jobs) costs.push_back(BatchRender::estimateCost(job));
+    numThreads = std::min(numThreads, static_cast<int>(std::max<size_t>(jobs.size(), 1)));
+
+    std::vector<BatchRender::Buffers> buffers(static_cast<size_t>(numThreads));
+    std::vector<BatchRender::Result> results(jobs.size());
+    std::mutex printLock;
+    const auto start = std::chrono::steady_clock::now();
+    BatchRender::runJobs(costs, numThreads, [&](size_t j, int worker) {
+        results[j] = BatchRender::renderJob(jobs[j], options, buffers[static_cast<size_t>(worker)]);
+        std::lock_guard<std::mutex> guard(printLock);
+        if (!results[j].ok) std::fprintf(stderr, "%s: %s\n", jobs[j].input.c_str(), results[j].error.c_str());
+        else if (!quiet)
+            std::fprintf(stderr, "%s: %llu frames x %d ch\n", jobs[j].output.c_str(),
+                         static_cast<unsigned long long>(results[j].frames), results[j].numChannels);
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed = 0;
+    double audioSeconds = 0.0;
+    for (const auto& result : results) {
+        if (!result.ok) ++failed;
+        else audioSeconds += static_cast<double>(result.frames) / result.sampleRate;
+    }
+    if (!quiet)
+        std::fprintf(stderr, "%zu jobs (%d failed), %.3f s audio in %.3f s (%.1fx real-time, %d threads, %s)\n", jobs.size(),
+                     failed, audioSeconds, seconds, seconds > 0.0 ? audioSeconds / seconds : 0.0, numThreads,
+                     TeeBeeMultiChannelFilter::getIsaName(std::min(options.maxIsa, TeeBeeMultiChannelFilter::detectIsa())));
+    return failed == 0 ? 0 : 1;
+}
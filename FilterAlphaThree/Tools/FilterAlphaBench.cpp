@@ -0,0 +1,502 @@
+// filteralpha-bench: Google Benchmark suite for the TeeBeeFilter DSP core.
+//
+// Every benchmark runs one filter (one voice) over a buffer of `block` samples and reports
+//   ns_per_sample    - wall time per processed sample
+//   voices_per_core  - how many real-time voices one core sustains at that sample rate
+// Arguments are {mode, sample rate, block size}. "Static" keeps the parameters fixed,
+// "Automated" pushes new cutoff/resonance/feedback values into the filter every sample;
+// "Ramped" follows the same automation with TeeBeeFilter::rampTo every 16 samples.
+// "CoefficientUpdate" times setCutoff + setFeedbackHP alone, {table} = exp() or TeeBeeCoefficientTable.
+//
+// "MultiChannel" runs TeeBeeMultiChannelFilter with {mode, channels, isa, quality} at 48 kHz / 512 samples;
+// ns_per_sample and voices_per_core there count every channel as one voice. "Saturator" is the same
+// benchmark in TB_303 mode across the tanh quality tiers (exact, table, pade). "Precision" runs it at
+// {mode, channels, precision, double_io}: double, mixed or float arithmetic, float or double buffers.
+// "Modulated" runs it at {channels, source}: 0 static, 1 an automation point at the end of every
+// block (Automation Mode), 2 a 230 Hz sidechain modulating cutoff and resonance (processAutomated).
+// "ZdfLadder" sets TB_303_ZDF at the host rate against TB_303 oversampled: {mode, factor}, stereo at
+// 44.1 kHz, counters per host-rate sample.
+//
+// JSON for CI:   filteralpha-bench --benchmark_out=bench.json --benchmark_out_format=json
+// Compare:       python3 Tools/compare_bench.py baseline.json bench.json
+
+#include "TeeBeeFilterBank.h"
+#include "TeeBeeMultiChannelFilter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* const modeLabels[] = { "TB_303", "LP_24", "LP_18", "LP_12", "HP_12", "FLAT", "TB_303_ZDF" };
+const int sampleRates[] = { 44100, 48000, 96000, 192000 };
+const int blockSizes[] = { 16, 64, 256, 1024, 4096 };
+const char* const qualityLabels[] = { "exact", "table", "pade" };
+
+std::vector<float> makeInput(int numSamples)
+{
+    // Saw plus a little noise: keeps every ladder stage and the saturators busy.
+    std::mt19937 rng(303);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    std::vector<float> input(static_cast<size_t>(numSamples));
+    float phase = 0.0f;
+    for (auto& x : input) {
+        phase += 110.0f / 44100.0f;
+        if (phase >= 1.0f) phase -= 1.0f;
+        x = 0.8f * (2.0f * phase - 1.0f) + noise(rng);
+    }
+    return input;
+}
+
+TeeBeeFilter makeFilter(int mode, double sampleRate)
+{
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    params.applyTo(filter);
+    filter.reset();
+    return filter;
+}
+
+void setCounters(benchmark::State& state, double sampleRate, int block)
+{
+    const double samples = static_cast<double>(state.iterations()) * block;
+    state.SetItemsProcessed(static_cast<int64_t>(samples));
+    // Inverted rate of (samples * 1e-9) reads as nanoseconds per sample.
+    state.counters["ns_per_sample"] = benchmark::Counter(samples * 1e-9, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["voices_per_core"] = benchmark::Counter(samples / sampleRate, benchmark::Counter::kIsRate);
+}
+
+void labelState(benchmark::State& state)
+{
+    state.SetLabel(modeLabels[state.range(0)]);
+}
+
+void BM_ProcessSample_Static(benchmark::State& state)
+{
+    const int mode = static_cast<int>(state.range(0));
+    const double sampleRate = static_cast<double>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    auto filter = makeFilter(mode, sampleRate);
+    const auto input = makeInput(block);
+    std::vector<float> output(input.size());
+
+    for (auto _ : state) {
+        for (int i = 0; i < block; ++i) output[i] = filter.processSample(input[i]);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block);
+    labelState(state);
+}
+
+void BM_ProcessBlock_Static(benchmark::State& state)
+{
+    const int mode = static_cast<int>(state.range(0));
+    const double sampleRate = static_cast<double>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    auto filter = makeFilter(mode, sampleRate);
+    const auto input = makeInput(block);
+    std::vector<float> output(input.size());
+
+    for (auto _ : state) {
+        std::copy(input.begin(), input.end(), output.begin());
+        filter.processBlock(output.data(), block);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block);
+    labelState(state);
+}
+
+void BM_ProcessSample_Automated(benchmark::State& state)
+{
+    const int mode = static_cast<int>(state.range(0));
+    const double sampleRate = static_cast<double>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    auto filter = makeFilter(mode, sampleRate);
+    const auto input = makeInput(block);
+    std::vector<float> output(input.size());
+
+    // One LFO period per block: cutoff 200 Hz..5 kHz, resonance and feedback HP follow.
+    std::vector<double> cutoff(input.size()), resonance(input.size()), fbHp(input.size());
+    for (int i = 0; i < block; ++i) {
+        const double lfo = 0.5 + 0.5 * std::sin(2.0 * TeeBeeFilter::pi * i / block);
+        cutoff[i] = 200.0 * std::pow(25.0, lfo);
+        resonance[i] = 0.2 + 0.6 * lfo;
+        fbHp[i] = 100.0 + 400.0 * lfo;
+    }
+
+    for (auto _ : state) {
+        for (int i = 0; i < block; ++i) {
+            filter.setCutoff(cutoff[i]);
+            filter.setResonance(resonance[i]);
+            filter.setFeedbackHP(fbHp[i]);
+            output[i] = filter.processSample(input[i]);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block);
+    labelState(state);
+}
+
+void BM_ProcessBlock_Ramped(benchmark::State& state)
+{
+    constexpr int subBlock = 16;
+    const int mode = static_cast<int>(state.range(0));
+    const double sampleRate = static_cast<double>(state.range(1));
+    const int block = static_cast<int>(state.range(2));
+    auto filter = makeFilter(mode, sampleRate);
+    const auto input = makeInput(block);
+    std::vector<float> output(input.size());
+
+    // Same LFO as BM_ProcessSample_Automated, sampled at the end of every sub-block
+    std::vector<double> cutoff, resonance, fbHp;
+    for (int i = subBlock - 1; i < block + subBlock - 1; i += subBlock) {
+        const double lfo = 0.5 + 0.5 * std::sin(2.0 * TeeBeeFilter::pi * std::min(i, block - 1) / block);
+        cutoff.push_back(200.0 * std::pow(25.0, lfo));
+        resonance.push_back(0.2 + 0.6 * lfo);
+        fbHp.push_back(100.0 + 400.0 * lfo);
+    }
+
+    for (auto _ : state) {
+        std::copy(input.begin(), input.end(), output.begin());
+        for (int start = 0, s = 0; start < block; start += subBlock, ++s) {
+            const int length = std::min(subBlock, block - start);
+            filter.rampTo(cutoff[s], resonance[s], filter.driveDb, fbHp[s], filter.feedbackAmp * 100.0, length);
+            filter.processBlock(output.data() + start, length);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block);
+    labelState(state);
+}
+
+void BM_CoefficientUpdate(benchmark::State& state)
+{
+    constexpr double sampleRate = 48000.0;
+    TeeBeeFilter filter;
+    filter.setSampleRate(sampleRate);
+    const auto table = TeeBeeCoefficientTable::forSampleRate(sampleRate);
+    if (state.range(0) != 0) filter.setCoefficientTable(table.get());
+
+    std::vector<double> cutoff(1024);
+    for (size_t i = 0; i < cutoff.size(); ++i) cutoff[i] = 20.0 * std::pow(1000.0, static_cast<double>(i) / cutoff.size());
+
+    for (auto _ : state) {
+        for (double fc : cutoff) {
+            filter.setCutoff(fc);
+            filter.setFeedbackHP(fc * 0.5);
+        }
+        benchmark::DoNotOptimize(filter);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cutoff.size()));
+    state.SetLabel(state.range(0) != 0 ? "table" : "exp");
+}
+
+void BM_MultiChannel(benchmark::State& state)
+{
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    const int mode = static_cast<int>(state.range(0));
+    const int numChannels = static_cast<int>(state.range(1));
+    const auto requested = static_cast<Isa>(state.range(2));
+    const int quality = static_cast<int>(state.range(3));
+    constexpr double sampleRate = 48000.0;
+    constexpr int block = 512;
+
+    TeeBeeMultiChannelFilter engine;
+    if (engine.setMaxIsa(requested) != requested) {
+        state.SkipWithError("instruction set not available on this CPU");
+        return;
+    }
+    engine.prepare(numChannels, sampleRate, block);
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    params.quality = quality;
+    engine.setParameters(params);
+
+    const auto input = makeInput(block);
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(numChannels), std::vector<float>(input.size()));
+    std::vector<float*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        engine.process(channels.data(), numChannels, block);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(std::string(modeLabels[mode]) + " " + TeeBeeMultiChannelFilter::getIsaName(requested) + " "
+                   + qualityLabels[quality]);
+}
+
+// Stereo TB-303 through the engine with oversampling; counters are per host-rate sample
+void BM_Oversampling(benchmark::State& state)
+{
+    const int factor = static_cast<int>(state.range(0));
+    const auto phase = state.range(1) != 0 ? TeeBeeOversampler::Phase::Linear : TeeBeeOversampler::Phase::Minimum;
+    constexpr int numChannels = 2, block = 512;
+    constexpr double sampleRate = 48000.0;
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, block);
+    engine.setOversampling(factor, phase);
+    TeeBeeParameters params;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    engine.setParameters(params);
+
+    const auto input = makeInput(block);
+    std::vector<std::vector<float>> buffers(numChannels, std::vector<float>(input.size()));
+    std::vector<float*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        engine.process(channels.data(), numChannels, block);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(std::to_string(factor) + "x " + (state.range(1) != 0 ? "linear" : "min") + " phase, latency "
+                   + std::to_string(engine.getLatencySamples()));
+}
+
+// What staying in tune costs: the zero-delay ladder at 1x against the TB_303 ladder oversampled
+void BM_ZdfLadder(benchmark::State& state)
+{
+    const int mode = static_cast<int>(state.range(0));
+    const int factor = static_cast<int>(state.range(1));
+    constexpr int numChannels = 2, block = 512;
+    constexpr double sampleRate = 44100.0;
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, block);
+    engine.setOversampling(factor, TeeBeeOversampler::Phase::Minimum);
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    engine.setParameters(params);
+
+    const auto input = makeInput(block);
+    std::vector<std::vector<float>> buffers(numChannels, std::vector<float>(input.size()));
+    std::vector<float*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        engine.process(channels.data(), numChannels, block);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(std::string(modeLabels[mode]) + " " + std::to_string(factor) + "x");
+}
+
+// TeeBeeMultiChannelFilter at {mode, channels, precision, double buffers} on the best ISA, 48 kHz / 512.
+// Padé saturator, so the cost is the ladder arithmetic rather than per-lane libm tanh
+template <class Sample>
+void runPrecision(benchmark::State& state, TeeBeeMultiChannelFilter& engine, int numChannels, int block)
+{
+    const auto input = makeInput(block);
+    std::vector<std::vector<Sample>> buffers(static_cast<size_t>(numChannels), std::vector<Sample>(input.size()));
+    std::vector<Sample*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        engine.process(channels.data(), numChannels, block);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+void BM_Precision(benchmark::State& state)
+{
+    static const char* const precisionLabels[] = { "double", "mixed", "float" };
+    const int mode = static_cast<int>(state.range(0));
+    const int numChannels = static_cast<int>(state.range(1));
+    const int precision = static_cast<int>(state.range(2));
+    const bool doubleBuffers = state.range(3) != 0;
+    constexpr double sampleRate = 48000.0;
+    constexpr int block = 512;
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, block);
+    engine.setPrecision(precision);
+    TeeBeeParameters params;
+    params.mode = mode;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    params.quality = QUALITY_PADE;
+    engine.setParameters(params);
+
+    if (doubleBuffers) runPrecision<double>(state, engine, numChannels, block);
+    else runPrecision<float>(state, engine, numChannels, block);
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(std::string(modeLabels[mode]) + " " + precisionLabels[precision] + ", " + (doubleBuffers ? "double" : "float")
+                   + " I/O, " + TeeBeeMultiChannelFilter::getIsaName(engine.getIsa()));
+}
+
+// Stereo TB-303 fed silence, with and without silence detection (idle instances)
+void BM_SilentInput(benchmark::State& state)
+{
+    const bool detect = state.range(0) != 0;
+    constexpr int numChannels = 2, block = 512;
+    constexpr double sampleRate = 48000.0;
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, block);
+    if (detect) engine.setSilenceThreshold(TeeBeeMultiChannelFilter::defaultSilenceThreshold);
+    TeeBeeParameters params;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    engine.setParameters(params);
+
+    std::vector<std::vector<float>> buffers(numChannels, std::vector<float>(block));
+    std::vector<float*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::fill(buffer.begin(), buffer.end(), 0.0f);
+        engine.process(channels.data(), numChannels, block);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(detect ? (engine.isIdle() ? "detection, idle" : "detection, not idle") : "no detection");
+}
+
+// TB-303 through processAutomated() at 48 kHz / 512: static, gliding to a point per block, or
+// modulated at audio rate by a sidechain; counters count every channel as one voice
+void BM_Modulated(benchmark::State& state)
+{
+    static const char* const sourceLabels[] = { "static", "block glide", "sidechain" };
+    const int numChannels = static_cast<int>(state.range(0));
+    const int source = static_cast<int>(state.range(1));
+    constexpr double sampleRate = 48000.0;
+    constexpr int block = 512;
+
+    TeeBeeMultiChannelFilter engine;
+    engine.prepare(numChannels, sampleRate, block);
+    TeeBeeParameters params;
+    params.resonance = 70.0;
+    params.cutoff = 800.0;
+    engine.setParameters(params);
+
+    const auto input = makeInput(block);
+    std::vector<float> sidechain(input.size());
+    for (int i = 0; i < block; ++i) sidechain[i] = static_cast<float>(std::sin(2.0 * TeeBeeFilter::pi * 230.0 * i / sampleRate));
+    const TeeBeeModulationDepth depth { 2.0, 20.0 };
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(numChannels), std::vector<float>(input.size()));
+    std::vector<float*> channels;
+    for (auto& buffer : buffers) channels.push_back(buffer.data());
+
+    int blockIndex = 0;
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        // Alternating between two cutoffs, so every block glides
+        const TeeBeeParameterEvent point { block, PARAM_CUTOFF, (++blockIndex & 1) != 0 ? 1600.0 : 800.0 };
+        engine.processAutomated(channels.data(), numChannels, block, &point, source == 1 ? 1 : 0,
+                                source == 2 ? sidechain.data() : nullptr, depth);
+        benchmark::DoNotOptimize(channels.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numChannels);
+    state.SetLabel(sourceLabels[source]);
+}
+
+// N independent voices in one TeeBeeFilterBank, each with its own cutoff (and mode when mixed)
+void BM_FilterBank(benchmark::State& state)
+{
+    const int numVoices = static_cast<int>(state.range(0));
+    const bool mixedModes = state.range(1) != 0;
+    constexpr double sampleRate = 48000.0;
+    constexpr int block = 256;
+
+    TeeBeeFilterBank bank;
+    bank.prepare(numVoices, sampleRate, block);
+    for (int v = 0; v < numVoices; ++v) {
+        TeeBeeParameters params;
+        params.cutoff = 200.0 + 20.0 * v;
+        params.resonance = 70.0;
+        params.mode = mixedModes ? v % TeeBeeFilter::NUM_MODES : TeeBeeFilter::TB_303;
+        bank.allocateVoice(params);
+    }
+
+    const auto input = makeInput(block);
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(numVoices), std::vector<float>(input.size()));
+    std::vector<float*> voiceBuffers;
+    for (auto& buffer : buffers) voiceBuffers.push_back(buffer.data());
+
+    for (auto _ : state) {
+        for (auto& buffer : buffers) std::copy(input.begin(), input.end(), buffer.begin());
+        bank.process(voiceBuffers.data(), block);
+        benchmark::DoNotOptimize(voiceBuffers.data());
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, sampleRate, block * numVoices);
+    state.SetLabel(std::string(mixedModes ? "mixed modes " : "TB-303 ") + TeeBeeMultiChannelFilter::getIsaName(bank.getIsa()));
+}
+
+void allConfigurations(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "mode", "sr", "block" });
+    for (int mode = 0; mode < TeeBeeFilter::NUM_MODES; ++mode)
+        for (int sr : sampleRates)
+            for (int block : blockSizes)
+                b->Args({ mode, sr, block });
+}
+
+void multiChannelConfigurations(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "mode", "channels", "isa", "quality" });
+    for (int mode : { static_cast<int>(TeeBeeFilter::TB_303), static_cast<int>(TeeBeeFilter::LP_24),
+                      static_cast<int>(TeeBeeFilter::TB_303_ZDF) })
+        for (int channels : { 1, 2, 6, 8, 16 })
+            for (int isa = 0; isa <= static_cast<int>(TeeBeeMultiChannelFilter::Isa::AVX512); ++isa)
+                b->Args({ mode, channels, isa, QUALITY_EXACT });
+}
+
+void saturatorConfigurations(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "mode", "channels", "isa", "quality" });
+    for (int channels : { 1, 8 })
+        for (int isa = 0; isa <= static_cast<int>(TeeBeeMultiChannelFilter::Isa::AVX512); ++isa)
+            for (int quality = 0; quality < NUM_QUALITIES; ++quality)
+                b->Args({ TeeBeeFilter::TB_303, channels, isa, quality });
+}
+} // namespace
+
+BENCHMARK(BM_ProcessSample_Static)->Apply(allConfigurations);
+BENCHMARK(BM_ProcessBlock_Static)->Apply(allConfigurations);
+BENCHMARK(BM_ProcessSample_Automated)->Apply(allConfigurations);
+BENCHMARK(BM_ProcessBlock_Ramped)->Apply(allConfigurations);
+BENCHMARK(BM_CoefficientUpdate)->ArgName("table")->Arg(0)->Arg(1);
+BENCHMARK(BM_MultiChannel)->Apply(multiChannelConfigurations);
+BENCHMARK(BM_MultiChannel)->Name("BM_Saturator")->Apply(saturatorConfigurations);
+BENCHMARK(BM_FilterBank)->ArgNames({ "voices", "mixed" })->ArgsProduct({ { 1, 8, 64, 256, 512 }, { 0, 1 } });
+BENCHMARK(BM_Modulated)->ArgNames({ "channels", "source" })->ArgsProduct({ { 2, 8 }, { 0, 1, 2 } });
+BENCHMARK(BM_SilentInput)->ArgName("detect")->Arg(0)->Arg(1);
+BENCHMARK(BM_Precision)->ArgNames({ "mode", "channels", "precision", "double_io" })
+    ->ArgsProduct({ { TeeBeeFilter::TB_303, TeeBeeFilter::LP_24, TeeBeeFilter::TB_303_ZDF }, { 2, 8, 16 }, { 0, 1, 2 }, { 0, 1 } });
+BENCHMARK(BM_Oversampling)->ArgNames({ "factor", "linear" })->ArgsProduct({ { 1, 2, 4, 8 }, { 0, 1 } });
+BENCHMARK(BM_ZdfLadder)->ArgNames({ "mode", "factor" })
+    ->Args({ TeeBeeFilter::TB_303, 1 })->Args({ TeeBeeFilter::TB_303, 2 })->Args({ TeeBeeFilter::TB_303, 4 })
+    ->Args({ TeeBeeFilter::TB_303_ZDF, 1 });
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+// filteralpha-presets: builds and lists FilterAlpha preset banks (TeeBeeState.h).
+//   build <presets.csv> <bank.tbk>  one preset per row; the header row is "name" followed by
+//                                   parameter IDs in any order, missing columns take the defaults
+//   list <bank.tbk>                 prints every preset with its values
+// Choice and toggle parameters are given by index (mode 0 = TB-303, ...). Names cannot contain
+// commas and are cut to 31 bytes.
+
+#include "TeeBeeState.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void printUsage()
+{
+    std::fprintf(stderr,
+        "usage: filteralpha-presets build <presets.csv> <bank.tbk>\n"
+        "       filteralpha-presets list <bank.tbk>\n");
+}
+
+std::vector<std::string> splitCsv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    for (std::string field; std::getline(stream, field, ',');) {
+        const auto first = field.find_first_not_of(" \t\r"), last = field.find_last_not_of(" \t\r");
+        fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+    }
+    return fields;
+}
+
+int build(const char* csvPath, const char* bankPath)
+{
+    std::ifstream csv(csvPath);
+    if (!csv) { std::fprintf(stderr, "cannot open %s\n", csvPath); return 1; }
+    std::string line;
+    if (!std::getline(csv, line)) { std::fprintf(stderr, "%s is empty\n", csvPath); return 1; }
+    // Column -> parameter index; column 0 is the name
+    const auto header = splitCsv(line);
+    std::vector<int> columns(header.size(), -1);
+    for (size_t c = 1; c < header.size(); ++c) {
+        columns[c] = teeBeeParameterIndex(teeBeeParameterHash(header[c]));
+        if (columns[c] < 0) { std::fprintf(stderr, "unknown parameter '%s'\n", header[c].c_str()); return 2; }
+    }
+
+    std::vector<TeeBeePreset> presets;
+    for (int row = 2; std::getline(csv, line); ++row) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        const auto fields = splitCsv(line);
+        TeeBeePreset preset;
+        preset.name = fields[0];
+        std::copy(std::begin(teeBeeParameterDefaults), std::end(teeBeeParameterDefaults), preset.values);
+        for (size_t c = 1; c < fields.size() && c < columns.size(); ++c) {
+            char* end = nullptr;
+            const float value = std::strtof(fields[c].c_str(), &end);
+            if (fields[c].empty() || *end != '\0') {
+                std::fprintf(stderr, "%s:%d: bad value for %s\n", csvPath, row, header[c].c_str());
+                return 2;
+            }
+            preset.values[columns[c]] = value;
+        }
+        presets.push_back(preset);
+    }
+
+    const auto bytes = teeBeeWritePresetBank(presets);
+    std::ofstream bank(bankPath, std::ios::binary);
+    if (!bank.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        std::fprintf(stderr, "write error on %s\n", bankPath);
+        return 1;
+    }
+    std::fprintf(stderr, "%s: %zu presets, %zu bytes\n", bankPath, presets.size(), bytes.size());
+    return 0;
+}
+
+int list(const char* bankPath)
+{
+    std::ifstream file(bankPath, std::ios::binary);
+    if (!file) { std::fprintf(stderr, "cannot open %s\n", bankPath); return 1; }
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    TeeBeePresetBank bank;
+    if (!bank.open(bytes.data(), bytes.size())) { std::fprintf(stderr, "%s is not a preset bank\n", bankPath); return 1; }
+    std::printf("name");
+    for (const char* id : teeBeeParameterIds) std::printf(",%s", id);
+    std::printf("\n");
+    for (int i = 0; i < bank.getNumPresets(); ++i) {
+        float values[NUM_PARAMETERS];
+        std::copy(std::begin(teeBeeParameterDefaults), std::end(teeBeeParameterDefaults), values);
+        bank.getValues(i, values);
+        const auto name = bank.getName(i);
+        std::printf("%.*s", static_cast<int>(name.size()), name.data());
+        for (float value : values) std::printf(",%g", value);
+        std::printf("\n");
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc == 4 && std::strcmp(argv[1], "build") == 0) return build(argv[2], argv[3]);
+    if (argc == 3 && std::strcmp(argv[1], "list") == 0) return list(argv[2]);
+    printUsage();
+    return 2;
+}
@@ -0,0 +1,287 @@
+// filteralpha-render: offline WAV -> WAV rendering through the TeeBeeFilter DSP core.
+// Streams the input in large blocks so renders run at file speed instead of real-time speed.
+// With --stats, each block's cycles and guard counts (TeeBeeInstrumentation.h) are written as
+// CSV or JSON, picked by the file extension. With --sidechain, a second WAV file (mixed to mono)
+// modulates cutoff and resonance at audio rate, as the plug-in's sidechain input does.
+
+#include "TeeBeeMultiChannelFilter.h"
+#include "WavFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* const modeNames[] = { "tb303", "lp24", "lp18", "lp12", "hp12", "flat", "tb303zdf" };
+const char* const qualityNames[] = { "exact", "table", "pade" };
+const char* const phaseNames[] = { "min", "linear" };
+const char* const precisionNames[] = { "double", "mixed", "float" };
+
+void printUsage()
+{
+    std::fprintf(stderr,
+        "usage: filteralpha-render [options] <input.wav> <output.wav>\n"
+        "  --cutoff <Hz>        cutoff frequency, 20..20000 (default 1000)\n"
+        "  --resonance <%%>      resonance, 0..100 (default 20)\n"
+        "  --drive <dB>         pre-filter drive, -24..24 (default 0)\n"
+        "  --mode <name|index>  tb303, lp24, lp18, lp12, hp12, flat, tb303zdf (default tb303)\n"
+        "  --fbhp <Hz>          feedback high-pass cutoff, 20..20000 (default 300)\n"
+        "  --fbamp <%%>          feedback amount, 0..100 (default 50)\n"
+        "  --quality <name>     saturator: exact, table, pade (default exact)\n"
+        "  --oversampling <n>   1 (off), 2, 4 or 8 (default 1); latency is compensated\n"
+        "  --phase <name>       oversampling filters: min, linear (default min)\n"
+        "  --precision <name>   ladder arithmetic: double, mixed, float (default double)\n"
+        "  --bits <16|24|32>    output format, 32 = float (default 32)\n"
+        "  --block <frames>     streaming block size (default 65536)\n"
+        "  --isa <name>         cap the SIMD kernel: scalar, sse2, avx2, avx512 (default: best available)\n"
+        "  --stats <file>       per-block CPU timings and guard counts, .csv or .json\n"
+        "  --sidechain <file>   WAV file modulating cutoff and resonance (same rate; silence past its end)\n"
+        "  --sc-cutoff <oct>    sidechain to cutoff, -4..4 octaves at full scale (default 0)\n"
+        "  --sc-resonance <%%>   sidechain to resonance, -100..100 %% at full scale (default 0)\n"
+        "  --quiet              do not print throughput\n");
+}
+
+// Accepts one of `names` or its index
+bool parseChoice(const char* text, const char* const* names, int numNames, int& choice)
+{
+    for (int i = 0; i < numNames; ++i)
+        if (std::strcmp(text, names[i]) == 0) { choice = i; return true; }
+    char* end = nullptr;
+    const long index = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || index < 0 || index >= numNames) return false;
+    choice = static_cast<int>(index);
+    return true;
+}
+
+bool parseIsa(const char* text, TeeBeeMultiChannelFilter::Isa& isa)
+{
+    using Isa = TeeBeeMultiChannelFilter::Isa;
+    const struct { const char* name; Isa isa; } isas[] = {
+        { "scalar", Isa::Scalar }, { "sse2", Isa::SSE2 }, { "avx2", Isa::AVX2 }, { "avx512", Isa::AVX512 }
+    };
+    for (const auto& entry : isas)
+        if (std::strcmp(text, entry.name) == 0) { isa = entry.isa; return true; }
+    return false;
+}
+
+bool parseNumber(const char* text, double& value)
+{
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0';
+}
+
+bool endsWith(const std::string& text, const char* suffix)
+{
+    const size_t n = std::strlen(suffix);
+    return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+// One row per block, then (JSON only) the summary of the whole render
+bool writeStats(const std::string& path, const std::vector<TeeBeeBlockTiming>& records, const TeeBeeTimingStats& stats,
+                double sampleRate, const char* isa, const char* precision)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+    const bool json = endsWith(path, ".json");
+    if (json) std::fprintf(file, "{\n  \"blocks\": [\n");
+    else std::fprintf(file, "block,frames,channels,cycles,cycles_per_sample,smoothing_cycles,clip_guards,non_finite_resets\n");
+    for (size_t b = 0; b < records.size(); ++b) {
+        const auto& r = records[b];
+        const auto cycles = static_cast<unsigned long long>(r.cycles), smoothing = static_cast<unsigned long long>(r.smoothingCycles);
+        if (json)
+            std::fprintf(file, "    { \"frames\": %u, \"channels\": %u, \"cycles\": %llu, \"cycles_per_sample\": %.2f, "
+                               "\"smoothing_cycles\": %llu, \"clip_guards\": %u, \"non_finite_resets\": %u }%s\n",
+                         r.numSamples, r.numChannels, cycles, r.cyclesPerSample(), smoothing, r.clipGuards, r.nonFiniteResets,
+                         b + 1 < records.size() ? "," : "");
+        else
+            std::fprintf(file, "%zu,%u,%u,%llu,%.2f,%llu,%u,%u\n", b, r.numSamples, r.numChannels, cycles, r.cyclesPerSample(),
+                         smoothing, r.clipGuards, r.nonFiniteResets);
+    }
+    if (json)
+        std::fprintf(file, "  ],\n  \"summary\": { \"blocks\": %llu, \"isa\": \"%s\", \"precision\": \"%s\", "
+                           "\"min_cycles_per_sample\": %.2f, \"avg_cycles_per_sample\": %.2f, \"p99_cycles_per_sample\": %.2f, "
+                           "\"cycles_per_second\": %.0f, \"p99_load\": %.6f, \"smoothing_share\": %.4f, "
+                           "\"clip_guards\": %llu, \"non_finite_resets\": %llu }\n}\n",
+                     static_cast<unsigned long long>(stats.blocks), isa, precision, stats.minCyclesPerSample,
+                     stats.avgCyclesPerSample, stats.p99CyclesPerSample, stats.cyclesPerSecond, stats.p99Load(sampleRate),
+                     stats.smoothingShare, static_cast<unsigned long long>(stats.clipGuards),
+                     static_cast<unsigned long long>(stats.nonFiniteResets));
+    return std::fclose(file) == 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    TeeBeeParameters params;
+    int bits = 32, blockSize = 65536, oversampling = 1, phase = 0, precision = PRECISION_DOUBLE;
+    auto maxIsa = TeeBeeMultiChannelFilter::Isa::AVX512;
+    bool quiet = false;
+    std::vector<std::string> files;
+    std::string statsPath, sidechainPath;
+    TeeBeeModulationDepth depth;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        double value = 0.0;
+        if (arg == "--help" || arg == "-h") { printUsage(); return 0; }
+        if (arg == "--quiet") { quiet = true; continue; }
+        if (arg.rfind("--", 0) == 0 && !hasValue) { std::fprintf(stderr, "missing value for %s\n", arg.c_str()); return 2; }
+        if (arg == "--mode") {
+            if (!parseChoice(argv[++i], modeNames, TeeBeeFilter::NUM_MODES, params.mode)) { std::fprintf(stderr, "unknown mode '%s'\n", argv[i]); return 2; }
+            continue;
+        }
+        if (arg == "--quality") {
+            if (!parseChoice(argv[++i], qualityNames, NUM_QUALITIES, params.quality)) { std::fprintf(stderr, "unknown quality '%s'\n", argv[i]); return 2; }
+            continue;
+        }
+        if (arg == "--phase") {
+            if (!parseChoice(argv[++i], phaseNames, 2, phase)) { std::fprintf(stderr, "unknown phase '%s'\n", argv[i]); return 2; }
+            continue;
+        }
+        if (arg == "--precision") {
+            if (!parseChoice(argv[++i], precisionNames, NUM_PRECISIONS, precision)) { std::fprintf(stderr, "unknown precision '%s'\n", argv[i]); return 2; }
+            continue;
+        }
+        if (arg == "--stats") {
+            statsPath = argv[++i];
+#if !TEEBEE_INSTRUMENTATION
+            std::fprintf(stderr, "--stats: built with FILTERALPHA_INSTRUMENTATION=OFF\n");
+            return 2;
+#endif
+            continue;
+        }
+        if (arg == "--sidechain") {
+            sidechainPath = argv[++i];
+            continue;
+        }
+        if (arg == "--isa") {
+            if (!parseIsa(argv[++i], maxIsa)) { std::fprintf(stderr, "unknown instruction set '%s'\n", argv[i]); return 2; }
+            continue;
+        }
+        if (arg.rfind("--", 0) == 0 && !parseNumber(argv[i + 1], value)) { std::fprintf(stderr, "bad value for %s\n", arg.c_str()); return 2; }
+        if (arg == "--cutoff") params.cutoff = value;
+        else if (arg == "--resonance") params.resonance = value;
+        else if (arg == "--drive") params.drive = value;
+        else if (arg == "--fbhp") params.fbHp = value;
+        else if (arg == "--fbamp") params.fbAmp = value;
+        else if (arg == "--bits") bits = static_cast<int>(value);
+        else if (arg == "--block") blockSize = static_cast<int>(value);
+        else if (arg == "--oversampling") oversampling = static_cast<int>(value);
+        else if (arg == "--sc-cutoff") depth.cutoffOctaves = value;
+        else if (arg == "--sc-resonance") depth.resonance = value;
+        else if (arg.rfind("--", 0) == 0) { std::fprintf(stderr, "unknown option %s\n", arg.c_str()); printUsage(); return 2; }
+        else { files.push_back(arg); continue; }
+        ++i;
+    }
+
+    if (files.size() != 2 || blockSize <= 0) { printUsage(); return 2; }
+    if (oversampling != 1 && oversampling != 2 && oversampling != 4 && oversampling != 8) {
+        std::fprintf(stderr, "oversampling must be 1, 2, 4 or 8\n");
+        return 2;
+    }
+
+    std::string error;
+    WavFile::Reader reader;
+    if (!reader.open(files[0], error)) { std::fprintf(stderr, "%s\n", error.c_str()); return 1; }
+    WavFile::Writer writer;
+    if (!writer.open(files[1], reader.numChannels, reader.sampleRate, bits, error)) { std::fprintf(stderr, "%s\n", error.c_str()); return 1; }
+
+    WavFile::Reader sidechainReader;
+    if (!sidechainPath.empty()) {
+        if (!sidechainReader.open(sidechainPath, error)) { std::fprintf(stderr, "%s\n", error.c_str()); return 1; }
+        if (sidechainReader.sampleRate != reader.sampleRate) { std::fprintf(stderr, "%s: sample rate differs from the input\n", sidechainPath.c_str()); return 1; }
+        if (!depth.isActive() && !quiet) std::fprintf(stderr, "warning: --sidechain without --sc-cutoff or --sc-resonance has no effect\n");
+    }
+
+    if (reader.sampleRate < 44100.0 && !quiet)
+        std::fprintf(stderr, "warning: %.0f Hz input, filter coefficients assume 44100 Hz\n", reader.sampleRate);
+
+    const int numChannels = reader.numChannels;
+    TeeBeeMultiChannelFilter engine;
+    engine.setMaxIsa(maxIsa);
+    engine.prepare(numChannels, reader.sampleRate, blockSize);
+    engine.setOversampling(oversampling, phase == 0 ? TeeBeeOversampler::Phase::Minimum : TeeBeeOversampler::Phase::Linear);
+    engine.setPrecision(precision);
+    engine.setParameters(params);
+    engine.reset();
+
+    std::vector<float> interleaved(static_cast<size_t>(blockSize) * static_cast<size_t>(numChannels));
+    std::vector<std::vector<float>> channelData(static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(blockSize)));
+    std::vector<float*> channels;
+    for (auto& data : channelData) channels.push_back(data.data());
+    std::vector<float> sidechainInterleaved, modulation;
+    if (!sidechainPath.empty()) {
+        sidechainInterleaved.resize(static_cast<size_t>(blockSize) * static_cast<size_t>(sidechainReader.numChannels));
+        modulation.resize(static_cast<size_t>(blockSize));
+    }
+    std::uint64_t framesDone = 0;
+    TeeBeeTimingRing timingRing;
+    std::vector<TeeBeeBlockTiming> timings;
+    TeeBeeTimingWindow timingWindow(static_cast<size_t>(reader.numFrames / static_cast<std::uint64_t>(blockSize)) + 2);
+    const auto start = std::chrono::steady_clock::now();
+
+    // Oversampling latency: drop the first `latency` output frames and flush as many at the end,
+    // so the output lines up with the input
+    int latency = engine.getLatencySamples(), skip = latency;
+    for (int frames; (frames = reader.read(interleaved.data(), blockSize)) > 0 || latency > 0;) {
+        if (frames <= 0) {
+            frames = std::min(latency, blockSize);
+            std::fill(interleaved.begin(), interleaved.begin() + frames * numChannels, 0.0f);
+            latency -= frames;
+        }
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < frames; ++i) channels[ch][i] = interleaved[i * numChannels + ch];
+        if (!modulation.empty()) {
+            // Mixed to mono; zeros once the sidechain file ends
+            const int scChannels = sidechainReader.numChannels;
+            const int got = std::max(0, sidechainReader.read(sidechainInterleaved.data(), frames));
+            for (int i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (int ch = 0; i < got && ch < scChannels; ++ch) sum += sidechainInterleaved[static_cast<size_t>(i) * scChannels + ch];
+                modulation[static_cast<size_t>(i)] = sum / static_cast<float>(scChannels);
+            }
+        }
+        {
+            TeeBeeBlockTimer timer(timingRing, frames, numChannels);
+            engine.processAutomated(channels.data(), numChannels, frames, nullptr, 0, modulation.empty() ? nullptr : modulation.data(),
+                                    depth);
+            const auto counters = engine.takeCounters();
+            timer.addCounts(counters.clipGuards, counters.nonFiniteResets);
+        }
+        for (TeeBeeBlockTiming timing; timingRing.pop(timing);) {
+            timings.push_back(timing);
+            timingWindow.add(timing);
+        }
+        const int first = std::min(skip, frames);
+        skip -= first;
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = first; i < frames; ++i) interleaved[(i - first) * numChannels + ch] = channels[ch][i];
+        if (!writer.write(interleaved.data(), frames - first)) { std::fprintf(stderr, "write error on %s\n", files[1].c_str()); return 1; }
+        framesDone += static_cast<std::uint64_t>(frames - first);
+    }
+
+    if (!writer.close()) { std::fprintf(stderr, "write error on %s\n", files[1].c_str()); return 1; }
+    if (!statsPath.empty()
+        && !writeStats(statsPath, timings, timingWindow.getStats(), reader.sampleRate,
+                       TeeBeeMultiChannelFilter::getIsaName(engine.getIsa()), precisionNames[precision])) {
+        std::fprintf(stderr, "write error on %s\n", statsPath.c_str());
+        return 1;
+    }
+
+    if (!quiet) {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double audioSeconds = static_cast<double>(framesDone) / reader.sampleRate;
+        std::fprintf(stderr, "%s: %llu frames x %d ch, %.3f s audio in %.3f s (%.1fx real-time, %s, %s)\n",
+            files[1].c_str(), static_cast<unsigned long long>(framesDone), numChannels, audioSeconds, seconds,
+            seconds > 0.0 ? audioSeconds / seconds : 0.0, TeeBeeMultiChannelFilter::getIsaName(engine.getIsa()),
+            precisionNames[precision]);
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+#pragma once
+#ifndef TEEBEE_WAV_FILE_H_INCLUDED
+#define TEEBEE_WAV_FILE_H_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Minimal streaming RIFF/WAVE reader and writer for the command-line tools.
+ * - Reads 8/16/24/32-bit PCM and 32/64-bit float (plain and WAVE_FORMAT_EXTENSIBLE)
+ * - Writes 16/24-bit PCM or 32-bit float
+ * - Frames are exchanged as interleaved float so callers can work in large blocks
+ */
+namespace WavFile
+{
+enum SampleFormat { PCM = 1, IEEE_FLOAT = 3, EXTENSIBLE = 0xFFFE };
+
+inline std::uint32_t readLE(const unsigned char* p, int bytes)
+{
+    std::uint32_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+inline void writeLE(unsigned char* p, std::uint32_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+class Reader
+{
+public:
+    Reader() = default;
+    ~Reader() { close(); }
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    bool open(const std::string& path, std::string& error)
+    {
+        close();
+        file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) { error = "cannot open " + path; return false; }
+
+        unsigned char riff[12];
+        if (std::fread(riff, 1, 12, file) != 12 || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+            error = path + " is not a RIFF/WAVE file";
+            return false;
+        }
+
+        bool haveFormat = false;
+        for (;;) {
+            unsigned char chunk[8];
+            if (std::fread(chunk, 1, 8, file) != 8) { error = path + " has no data chunk"; return false; }
+            const std::uint32_t size = readLE(chunk + 4, 4);
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                std::vector<unsigned char> fmt(size);
+                if (size < 16 || std::fread(fmt.data(), 1, size, file) != size) { error = path + " has a broken fmt chunk"; return false; }
+                format = static_cast<int>(readLE(fmt.data(), 2));
+                numChannels = static_cast<int>(readLE(fmt.data() + 2, 2));
+                sampleRate = static_cast<double>(readLE(fmt.data() + 4, 4));
+                bitsPerSample = static_cast<int>(readLE(fmt.data() + 14, 2));
+                if (format == EXTENSIBLE && size >= 26) format = static_cast<int>(readLE(fmt.data() + 24, 2));
+                if (size & 1) std::fseek(file, 1, SEEK_CUR);
+                haveFormat = true;
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) { error = path + " has data before fmt"; return false; }
+                dataBytes = size;
+                break;
+            }
+            else {
+                std::fseek(file, static_cast<long>(size + (size & 1)), SEEK_CUR);
+            }
+        }
+
+        const bool pcmOk = format == PCM && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+        const bool floatOk = format == IEEE_FLOAT && (bitsPerSample == 32 || bitsPerSample == 64);
+        if (!(pcmOk || floatOk) || numChannels <= 0) { error = path + ": unsupported sample format"; return false; }
+
+        bytesPerFrame = numChannels * (bitsPerSample / 8);
+        framesRemaining = dataBytes / static_cast<std::uint64_t>(bytesPerFrame);
+        numFrames = framesRemaining;
+        return true;
+    }
+
+    // Reads up to maxFrames interleaved frames; returns the number read (0 at end of data).
+    int read(float* interleaved, int maxFrames)
+    {
+        if (file == nullptr || framesRemaining == 0) return 0;
+        const int frames = static_cast<int>(maxFrames < static_cast<std::int64_t>(framesRemaining) ? maxFrames : framesRemaining);
+        raw.resize(static_cast<size_t>(frames) * static_cast<size_t>(bytesPerFrame));
+        const size_t got = std::fread(raw.data(), static_cast<size_t>(bytesPerFrame), static_cast<size_t>(frames), file);
+        const int n = static_cast<int>(got) * numChannels;
+        const int bytes = bitsPerSample / 8;
+        const unsigned char* p = raw.data();
+        for (int i = 0; i < n; ++i, p += bytes) {
+            if (format == IEEE_FLOAT) {
+                if (bytes == 4) { float f; std::memcpy(&f, p, 4); interleaved[i] = f; }
+                else { double d; std::memcpy(&d, p, 8); interleaved[i] = static_cast<float>(d); }
+            }
+            else if (bytes == 1) {
+                interleaved[i] = (static_cast<float>(p[0]) - 128.0f) / 128.0f;
+            }
+            else {
+                const std::uint32_t u = readLE(p, bytes) << (32 - 8 * bytes);
+                interleaved[i] = static_cast<float>(static_cast<std::int32_t>(u) / 2147483648.0);
+            }
+        }
+        framesRemaining -= got;
+        if (static_cast<int>(got) < frames) framesRemaining = 0;
+        return static_cast<int>(got);
+    }
+
+    void close()
+    {
+        if (file != nullptr) std::fclose(file);
+        file = nullptr;
+    }
+
+    int numChannels = 0, bitsPerSample = 0, format = 0;
+    double sampleRate = 0.0;
+    std::uint64_t numFrames = 0;
+
+private:
+    std::FILE* file = nullptr;
+    std::uint32_t dataBytes = 0;
+    std::uint64_t framesRemaining = 0;
+    int bytesPerFrame = 0;
+    std::vector<unsigned char> raw;
+};
+
+class Writer
+{
+public:
+    Writer() = default;
+    ~Writer() { close(); }
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // bits: 16 or 24 for PCM, 32 for float.
+    bool open(const std::string& path, int channels, double rate, int bits, std::string& error)
+    {
+        close();
+        if (bits != 16 && bits != 24 && bits != 32) { error = "unsupported output bit depth"; return false; }
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) { error = "cannot create " + path; return false; }
+        numChannels = channels;
+        bitsPerSample = bits;
+        sampleRate = rate;
+        framesWritten = 0;
+        return writeHeader();
+    }
+
+    bool write(const float* interleaved, int frames)
+    {
+        if (file == nullptr || frames <= 0) return file != nullptr;
+        const int n = frames * numChannels;
+        const int bytes = bitsPerSample / 8;
+        raw.resize(static_cast<size_t>(n) * static_cast<size_t>(bytes));
+        unsigned char* p = raw.data();
+        for (int i = 0; i < n; ++i, p += bytes) {
+            const float x = interleaved[i];
+            if (bitsPerSample == 32) { std::memcpy(p, &x, 4); continue; }
+            const double scale = bitsPerSample == 16 ? 32767.0 : 8388607.0;
+            double v = static_cast<double>(x) * scale;
+            v = v < -scale - 1.0 ? -scale - 1.0 : (v > scale ? scale : v);
+            const auto s = static_cast<std::int32_t>(v < 0.0 ? v - 0.5 : v + 0.5);
+            writeLE(p, static_cast<std::uint32_t>(s), bytes);
+        }
+        framesWritten += static_cast<std::uint64_t>(frames);
+        return std::fwrite(raw.data(), 1, raw.size(), file) == raw.size();
+    }
+
+    bool close()
+    {
+        if (file == nullptr) return true;
+        std::fseek(file, 0, SEEK_SET);
+        const bool ok = writeHeader();
+        const bool closed = std::fclose(file) == 0;
+        file = nullptr;
+        return ok && closed;
+    }
+
+private:
+    bool writeHeader()
+    {
+        const int bytes = bitsPerSample / 8;
+        const std::uint32_t dataSize = static_cast<std::uint32_t>(framesWritten * static_cast<std::uint64_t>(numChannels * bytes));
+        unsigned char h[44];
+        std::memcpy(h, "RIFF", 4);
+        writeLE(h + 4, 36 + dataSize, 4);
+        std::memcpy(h + 8, "WAVEfmt ", 8);
+        writeLE(h + 16, 16, 4);
+        writeLE(h + 20, bitsPerSample == 32 ? IEEE_FLOAT : PCM, 2);
+        writeLE(h + 22, static_cast<std::uint32_t>(numChannels), 2);
+        writeLE(h + 24, static_cast<std::uint32_t>(sampleRate), 4);
+        writeLE(h + 28, static_cast<std::uint32_t>(sampleRate) * static_cast<std::uint32_t>(numChannels * bytes), 4);
+        writeLE(h + 32, static_cast<std::uint32_t>(numChannels * bytes), 2);
+        writeLE(h + 34, static_cast<std::uint32_t>(bitsPerSample), 2);
+        std::memcpy(h + 36, "data", 4);
+        writeLE(h + 40, dataSize, 4);
+        return std::fwrite(h, 1, 44, file) == 44;
+    }
+
+    std::FILE* file = nullptr;
+    int numChannels = 0, bitsPerSample = 32;
+    double sampleRate = 44100.0;
+    std::uint64_t framesWritten = 0;
+    std::vector<unsigned char> raw;
+};
+} // namespace WavFile
+
+#endif // TEEBEE_WAV_FILE_H_INCLUDED
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Compare two filteralpha-bench JSON files on ns_per_sample.
+
+usage: compare_bench.py <baseline.json> <current.json> [--threshold PERCENT]
+
+Prints one line per benchmark present in both files and exits with status 1
+if any benchmark got slower than the threshold (default 10 %).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+        if "ns_per_sample" in bench:
+            results[bench["name"]] = bench["ns_per_sample"]
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    for name in sorted(baseline.keys() & current.keys()):
+        before, after = baseline[name], current[name]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:60s} {before:9.2f} -> {after:9.2f} ns/sample ({change:+6.1f} %){flag}")
+
+    missing = sorted(baseline.keys() - current.keys())
+    for name in missing:
+        print(f"{name:60s} missing from {args.current}")
+
+    print(f"{regressions} regression(s) above {args.threshold:.1f} %")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())